@@ -9,10 +9,10 @@ namespace game {
     class ArrowPowerUp : public GameObject {
 
     public:
-        ArrowPowerUp(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable);
+        ArrowPowerUp(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable);
 
         // Update function for moving the player object around
-        void Update(double delta_time) override;
+        void Update(double delta_time, double current_time) override;
 
     }; // class ShockPowerUp
 
@@ -0,0 +1,176 @@
+/*
+ *
+ * Asset build step: packs the sprite images listed in a manifest into a single file
+ * that TextureAtlas uploads as one GL_TEXTURE_2D_ARRAY
+ *
+ * Usage: atlas_packer <manifest> <texture directory> <output file> [layer size]
+ *
+ * Every sprite is resampled to fill a whole layer, since sprites are always drawn on a square
+ * with texture coordinates spanning [0, 1] this looks the same as the original image
+ *
+ * Sprites are resampled on every hardware thread at once; SOIL keeps global state and is not thread-safe,
+ * so the decoding itself happens one image at a time
+ *
+ */
+
+#include <SOIL/SOIL.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "texture_atlas.h"
+
+// Resample an RGBA image to size x size
+// Averages every source pixel under a destination pixel when shrinking, interpolates when enlarging
+static void Resample(const unsigned char *src, int width, int height, unsigned char *dst, int size)
+{
+    float scale_x = (float) width / size;
+    float scale_y = (float) height / size;
+
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+            if (scale_x > 1.0f || scale_y > 1.0f) {
+                // Box filter over the covered source area
+                int x0 = (int) (x * scale_x);
+                int x1 = std::max(x0 + 1, (int) ((x + 1) * scale_x));
+                int y0 = (int) (y * scale_y);
+                int y1 = std::max(y0 + 1, (int) ((y + 1) * scale_y));
+                int count = 0;
+                for (int sy = y0; sy < y1 && sy < height; sy++) {
+                    for (int sx = x0; sx < x1 && sx < width; sx++) {
+                        for (int c = 0; c < 4; c++) {
+                            sum[c] += src[(sy * width + sx) * 4 + c];
+                        }
+                        count++;
+                    }
+                }
+                for (int c = 0; c < 4; c++) {
+                    sum[c] /= count;
+                }
+            }
+            else {
+                // Bilinear interpolation between the four nearest source pixels
+                float fx = std::max(0.0f, (x + 0.5f) * scale_x - 0.5f);
+                float fy = std::max(0.0f, (y + 0.5f) * scale_y - 0.5f);
+                int x0 = std::min((int) fx, width - 1);
+                int y0 = std::min((int) fy, height - 1);
+                int x1 = std::min(x0 + 1, width - 1);
+                int y1 = std::min(y0 + 1, height - 1);
+                float tx = fx - x0;
+                float ty = fy - y0;
+                for (int c = 0; c < 4; c++) {
+                    float top = src[(y0 * width + x0) * 4 + c] * (1.0f - tx) + src[(y0 * width + x1) * 4 + c] * tx;
+                    float bottom = src[(y1 * width + x0) * 4 + c] * (1.0f - tx) + src[(y1 * width + x1) * 4 + c] * tx;
+                    sum[c] = top * (1.0f - ty) + bottom * ty;
+                }
+            }
+
+            for (int c = 0; c < 4; c++) {
+                dst[(y * size + x) * 4 + c] = (unsigned char) (sum[c] + 0.5f);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <manifest> <texture directory> <output file> [layer size]" << std::endl;
+        return 1;
+    }
+    int layer_size = argc > 4 ? atoi(argv[4]) : 256;
+
+    // Read the sprite names
+    std::ifstream manifest(argv[1]);
+    if (manifest.fail()) {
+        std::cerr << "Error opening file " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<std::string> names;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        // Tolerate Windows line endings and blank lines
+        while (!line.empty() && (line[line.size() - 1] == '\r' || line[line.size() - 1] == ' ')) {
+            line.erase(line.size() - 1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (line.size() >= ATLAS_NAME_LENGTH) {
+            std::cerr << "Sprite name too long: " << line << std::endl;
+            return 1;
+        }
+        names.push_back(line);
+    }
+
+    // Decode and resample every sprite into its layer, each thread taking the next sprite left
+    size_t layer_bytes = (size_t) layer_size * layer_size * 4;
+    std::vector<unsigned char> pixels(layer_bytes * names.size());
+    std::vector<std::string> errors(names.size());
+    std::atomic<int> next_sprite(0);
+    std::mutex decode_mutex;
+    std::vector<std::thread> threads;
+    int num_threads = std::min((int) names.size(), (int) std::max(1u, std::thread::hardware_concurrency()));
+    for (int t = 0; t < num_threads; t++) {
+        threads.push_back(std::thread([&] {
+            for (int i = next_sprite++; i < names.size(); i = next_sprite++) {
+                std::string filename = std::string(argv[2]) + "/" + names[i] + ".png";
+                int width, height;
+                unsigned char *image;
+                {
+                    std::lock_guard<std::mutex> lock(decode_mutex);
+                    image = SOIL_load_image(filename.c_str(), &width, &height, 0, SOIL_LOAD_RGBA);
+                    if (!image) {
+                        errors[i] = "Error loading " + filename + ": " + SOIL_last_result();
+                    }
+                }
+                if (!image) {
+                    continue;
+                }
+                Resample(image, width, height, &pixels[i * layer_bytes], layer_size);
+                SOIL_free_image_data(image);
+            }
+        }));
+    }
+    for (int t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    for (int i = 0; i < names.size(); i++) {
+        if (!errors[i].empty()) {
+            std::cerr << errors[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // Write the packed file
+    std::ofstream out(argv[3], std::ios::binary);
+    if (out.fail()) {
+        std::cerr << "Error opening file " << argv[3] << std::endl;
+        return 1;
+    }
+    game::AtlasFileHeader header;
+    memcpy(header.magic, ATLAS_MAGIC, 4);
+    header.version = ATLAS_VERSION;
+    header.layer_size = layer_size;
+    header.num_layers = names.size();
+    out.write((const char *) &header, sizeof(header));
+    for (int i = 0; i < names.size(); i++) {
+        char name[ATLAS_NAME_LENGTH];
+        memset(name, 0, ATLAS_NAME_LENGTH);
+        strncpy(name, names[i].c_str(), ATLAS_NAME_LENGTH - 1);
+        out.write(name, ATLAS_NAME_LENGTH);
+    }
+    out.write((const char *) &pixels[0], pixels.size());
+
+    std::cout << "Packed " << names.size() << " sprites into " << argv[3] << std::endl;
+    return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef ATLAS_REGION_H_
+#define ATLAS_REGION_H_
+
+namespace game {
+
+    // Sprites used by the game, each one is a layer of the sprite atlas
+    enum SpriteId {
+        SPRITE_CHOPPER,
+        SPRITE_ALIEN,
+        SPRITE_SPACE,
+        SPRITE_BLADE,
+        SPRITE_BULLET,
+        SPRITE_ORB,
+        SPRITE_SHIELD,
+        SPRITE_DONUT,
+        SPRITE_CLOWN,
+        SPRITE_STAR,
+        SPRITE_PENGUIN,
+        SPRITE_BOW,
+        SPRITE_ARROW,
+        SPRITE_EXPLOSION,
+        NUM_SPRITES
+    };
+
+    // Names of the sprites in the atlas (file names in textures/ without the extension), indexed by SpriteId
+    static const char *const sprite_names_g[NUM_SPRITES] = {
+        "chopper", "alien", "space", "blade", "bullet", "orb", "shield",
+        "donut", "clown", "star", "penguin", "bow", "arrow", "explosion"
+    };
+
+    // Where a sprite lives in the atlas
+    // Every sprite fills a whole layer of the array texture, so its texture coordinates always span [0, 1]
+    struct AtlasRegion {
+        int layer;
+
+        AtlasRegion(void) : layer(0) {}
+        explicit AtlasRegion(int layer) : layer(layer) {}
+    };
+
+} // namespace game
+
+#endif // ATLAS_REGION_H_
@@ -8,6 +8,7 @@ namespace audio_manager {
     AudioManager::AudioManager(void) {
 
         initialized_ = 0;
+        num_one_shots_ = 0;
 
     }
 
@@ -20,7 +21,7 @@ namespace audio_manager {
     }
 
 
-    void AudioManager::Init(const char* device_name) {
+    void AudioManager::Init(const char* device_name, int num_voices) {
 
         if (!initialized_) {
             ALCdevice* device = NULL;
@@ -51,6 +52,13 @@ namespace audio_manager {
             /* Initialize the Alut library */
             alutInitWithoutContext(NULL, NULL);
 
+            /* Create the voice pool once, playing never creates sources */
+            voice_.resize(num_voices);
+            voice_start_.assign(num_voices, 0);
+            alGenSources((ALsizei)num_voices, &voice_[0]);
+            CheckForErrors("Failed to generate voices");
+            num_one_shots_ = 0;
+
             /* Remember that we initialized the audio system */
             initialized_ = 1;
         }
@@ -63,10 +71,21 @@ namespace audio_manager {
 
             ALCdevice* device;
 
+            /* Voices reference the buffers, so they go first */
+            if (!voice_.empty()) {
+                alSourceStopv((ALsizei)voice_.size(), &voice_[0]);
+                alDeleteSources((ALsizei)voice_.size(), &voice_[0]);
+            }
+            voice_.clear();
+            voice_start_.clear();
+
             for (int i = 0; i < buffer_.size(); i++) {
                 alDeleteSources(1, &source_[i]);
                 alDeleteBuffers(1, &buffer_[i]);
             }
+            buffer_.clear();
+            source_.clear();
+            buffer_index_.clear();
             device = alcGetContextsDevice(context_);
             alcMakeContextCurrent(NULL);
             alcDestroyContext(context_);
@@ -84,6 +103,12 @@ namespace audio_manager {
         ALuint buffer;
         ALuint source;
 
+        /* Reuse the buffer if the file was already loaded */
+        std::map<std::string, int>::iterator it = buffer_index_.find(filename);
+        if (it != buffer_index_.end()) {
+            return it->second;
+        }
+
         /* Load data from wav file with Alut library */
         buffer = alutCreateBufferFromFile(filename);
         if (!buffer) {
@@ -102,6 +127,7 @@ namespace audio_manager {
         source_.push_back(source);
 
         /* Return index of last added buffer */
+        buffer_index_[filename] = buffer_.size() - 1;
         return buffer_.size() - 1;
     }
 
@@ -118,6 +144,37 @@ namespace audio_manager {
     }
 
 
+    void AudioManager::PlayOneShot(int index, double x, double y, double z) {
+
+        if (voice_.empty() || index < 0 || index >= buffer_.size()) {
+            return;
+        }
+
+        /* Take a voice that is done playing, or steal the oldest one */
+        int voice = 0;
+        for (int i = 0; i < voice_.size(); i++) {
+            ALint state;
+            alGetSourcei(voice_[i], AL_SOURCE_STATE, &state);
+            if (state != AL_PLAYING) {
+                voice = i;
+                break;
+            }
+            if (voice_start_[i] < voice_start_[voice]) {
+                voice = i;
+            }
+        }
+
+        /* Restart the voice with the new sound */
+        alSourceStop(voice_[voice]);
+        alSourcei(voice_[voice], AL_BUFFER, buffer_[index]);
+        alSourcei(voice_[voice], AL_LOOPING, AL_FALSE);
+        alSource3f(voice_[voice], AL_POSITION, x, y, z);
+        alSourcePlay(voice_[voice]);
+        CheckForErrors("Failed to play voice");
+        voice_start_[voice] = ++num_one_shots_;
+    }
+
+
     bool AudioManager::SoundIsPlaying(int index) {
 
         ALint source_state;
@@ -136,6 +193,13 @@ namespace audio_manager {
                 return true;
             }
         }
+        for (int i = 0; i < voice_.size(); i++) {
+            ALint source_state;
+            alGetSourcei(voice_[i], AL_SOURCE_STATE, &source_state);
+            if (source_state == AL_PLAYING) {
+                return true;
+            }
+        }
         return false;
     }
 
@@ -10,6 +10,8 @@
 
 #include <exception>
 #include <iostream>
+#include <map>
+#include <string>
 #include <vector>
 
 namespace audio_manager {
@@ -25,25 +27,36 @@ namespace audio_manager {
         virtual const char* what() const throw() { return message_.c_str(); };
     };
 
-    // A simple audio manager implemented with OpenAl
+    /* A simple audio manager implemented with OpenAl
+     * It is meant to live for the whole program: initialize it once,
+     * load every sound up front and then fire sounds with PlayOneShot,
+     * which never blocks and never allocates */
     class AudioManager {
     public:
         AudioManager(void);
         ~AudioManager();
         /* Initialize the audio system. device_name is the name of
          * the audio device to be used. If the default device should
-         * be used, set device_name to NULL. */
-        void Init(const char* device_name);
+         * be used, set device_name to NULL. num_voices is the number
+         * of sources shared by all one-shot sounds, that is, how
+         * many of them can be heard at the same time */
+        void Init(const char* device_name, int num_voices = 16);
         // Shut down the audio system
         void ShutDown(void);
         /* Load a wav audio file and add its contents to a buffer.
          * The buffer can then be played multiple times with
          * PlaySound. AddSound returns the index of the file in
          * the list of buffers. This index should be passed to
-         * PlaySound to play the respective file */
+         * PlaySound to play the respective file. Loading the same
+         * file again returns the index of the existing buffer */
         int AddSound(const char* filename);
         // Play buffer with specific index
         void PlaySound(int index);
+        /* Play buffer with specific index at a position on a voice
+         * from the pool and return right away. Many copies of the
+         * same sound can overlap. When every voice is busy the one
+         * that started first is cut off and reused */
+        void PlayOneShot(int index, double x, double y, double z);
         // Check if the buffer with the given index is being played
         bool SoundIsPlaying(int index);
         // Check if any buffer is being played
@@ -65,6 +78,14 @@ namespace audio_manager {
         std::vector<ALuint> buffer_;
         // One source for each buffer
         std::vector<ALuint> source_;
+        // Index of each loaded file, so it is only decoded once
+        std::map<std::string, int> buffer_index_;
+
+        // Pool of sources used by PlayOneShot
+        std::vector<ALuint> voice_;
+        // When each voice was last started, to pick the one to steal
+        std::vector<unsigned long> voice_start_;
+        unsigned long num_one_shots_;
 
         // Keep track if we already initialized the audio manager
         int initialized_;
@@ -0,0 +1,39 @@
+// Source code of fragment shader for the scrolling background
+#version 330
+
+// Must match MAX_BACKGROUND_LAYERS in scrolling_background.h
+#define MAX_LAYERS 4
+
+// Attributes passed from the vertex shader
+in vec2 world_interp;
+
+// Sprite atlas, sampled with GL_REPEAT wrapping
+uniform sampler2DArray onetex;
+
+// Per layer: atlas layer, tile size, parallax, opacity
+uniform vec4 layers[MAX_LAYERS];
+uniform int num_layers;
+
+// Point the view is centered on
+uniform vec2 camera_position;
+
+// Output color
+out vec4 frag_color;
+
+void main()
+{
+    vec3 color = vec3(0.0);
+    for (int i = 0; i < num_layers; i++) {
+        // A layer with parallax p scrolls by p times the camera's movement
+        vec2 position = world_interp - camera_position * (1.0 - layers[i].z);
+
+        // Tiles are centered on the origin, texture rows run downwards
+        vec2 uv = vec2(0.5 + position.x / layers[i].y, 0.5 - position.y / layers[i].y);
+        vec4 texel = texture(onetex, vec3(uv, layers[i].x));
+
+        // Back to front
+        color = mix(color, texel.rgb, texel.a * layers[i].w);
+    }
+
+    frag_color = vec4(color, 1.0);
+}
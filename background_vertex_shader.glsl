@@ -0,0 +1,21 @@
+// Source code of vertex shader for the scrolling background
+#version 330
+
+// Per-frame data shared by every program (see frame_uniforms.h)
+layout(std140) uniform FrameUniforms {
+    mat4 view_matrix;
+    float time;
+};
+
+// World position under the vertex, interpolated across the screen
+out vec2 world_interp;
+
+void main()
+{
+    // One triangle covering the whole screen, corners (-1, -1), (3, -1) and (-1, 3)
+    vec2 corner = vec2((gl_VertexID == 1) ? 3.0 : -1.0, (gl_VertexID == 2) ? 3.0 : -1.0);
+    gl_Position = vec4(corner, 0.0, 1.0);
+
+    // Undo the view to find where the corner lies in the world
+    world_interp = (inverse(view_matrix) * vec4(corner, 0.0, 1.0)).xy;
+}
@@ -0,0 +1,377 @@
+/*
+ *
+ * Microbenchmarks of the hot paths, runs without a window, OpenGL context or audio device
+ *
+ * Usage: yume_bench [--filter text] [--min-time seconds] [--out file]
+ *
+ * Every benchmark whose name contains the filter text is run for at least min-time seconds,
+ * the results are printed and, with --out, written as JSON so that builds can be compared
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#ifdef YUME_BENCH_SOIL
+#include <SOIL/SOIL.h>
+#endif
+
+#include <path_config.h>
+
+#include "clock.h"
+#include "emitter_manager.h"
+#include "entity_store.h"
+#include "file_utils.h"
+#include "ray_circle.h"
+#include "sprite_culler.h"
+#include "sprite_transform.h"
+#include "world.h"
+
+// Macro for printing exceptions
+#define PrintException(exception_object)\
+    std::cerr << exception_object.what() << std::endl
+
+// Results land here so that the compiler cannot drop the work
+static volatile float sink_g;
+
+struct BenchResult {
+    std::string name;
+    long long iterations;
+    double ns_per_op;
+    int items_per_op;
+};
+
+struct Bench {
+    std::vector<BenchResult> results;
+    std::string filter;
+    double min_time;
+
+    // Time body(iterations), doubling the iterations until it runs for at least min_time
+    // items is how many elements one iteration processes, for the per-item cost
+    void Run(const std::string& name, int items, const std::function<void(long long)>& body) {
+        if (name.find(filter) == std::string::npos) {
+            return;
+        }
+
+        long long iterations = 1;
+        double elapsed = 0.0;
+        while (true) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            body(iterations);
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (elapsed >= min_time || iterations >= (1LL << 40)) {
+                break;
+            }
+            iterations *= 2;
+        }
+
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.ns_per_op = elapsed * 1e9 / iterations;
+        result.items_per_op = items;
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(32) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1)
+                  << result.ns_per_op << " ns/op" << std::setw(12) << std::setprecision(2) << result.ns_per_op / items << " ns/item"
+                  << std::setw(12) << iterations << " iterations" << std::endl;
+    }
+
+    // Machine-readable results
+    void Write(const char* filename) const {
+        std::ofstream out(filename);
+        if (out.fail()) {
+            throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+        }
+        out << "{\n  \"benchmarks\": [";
+        for (int i = 0; i < results.size(); i++) {
+            out << (i ? "," : "") << "\n    {\"name\": \"" << results[i].name << "\", \"iterations\": " << results[i].iterations
+                << ", \"ns_per_op\": " << results[i].ns_per_op << ", \"items_per_op\": " << results[i].items_per_op << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+};
+
+
+// One ray against many circles: the original closed form, the scalar test and the batched kernel
+static void BenchRayCircle(Bench& bench)
+{
+    const int count = 1024;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(-20.0f, 20.0f);
+    game::CircleSet circles;
+    for (int i = 0; i < count; i++) {
+        circles.Add(glm::vec2(coordinate(rng), coordinate(rng)), 0.5f);
+    }
+    glm::vec2 origin(0.3f, -0.7f);
+    glm::vec2 direction(8.0f, 3.0f);
+
+    bench.Run("ray_circle/reference", count, [&](long long iterations) {
+        float sum = 0.0f;
+        for (long long n = 0; n < iterations; n++) {
+            for (int i = 0; i < count; i++) {
+                std::pair<float, float> t = game::RayCircleCollisionMath(glm::vec3(origin, 0.0f), glm::vec3(direction, 0.0f), glm::vec3(circles.center_x[i], circles.center_y[i], 0.0f));
+                sum += t.first;
+            }
+        }
+        sink_g = sum;
+    });
+
+    bench.Run("ray_circle/scalar", count, [&](long long iterations) {
+        float sum = 0.0f;
+        for (long long n = 0; n < iterations; n++) {
+            for (int i = 0; i < count; i++) {
+                float t;
+                if (game::RayCircleHit(origin, direction, glm::vec2(circles.center_x[i], circles.center_y[i]), circles.radius[i], 1.0f, t)) {
+                    sum += t;
+                }
+            }
+        }
+        sink_g = sum;
+    });
+
+    bench.Run("ray_circle/kernel", count, [&](long long iterations) {
+        float sum = 0.0f;
+        for (long long n = 0; n < iterations; n++) {
+            float t = 0.0f;
+            sum += game::RayCirclesEarliestHit(origin, direction, circles, 1.0f, t) + t;
+        }
+        sink_g = sum;
+    });
+}
+
+
+// A whole simulation step (behaviours, integration, broad and narrow phase) with n enemies
+// With an activity radius only the enemies near the player are awake, the cost should barely grow with n
+// Given a thread count the case is named after it instead, to show how the step scales at a fixed n
+static void BenchWorldStep(Bench& bench, int n, float activity_radius = 0.0f, int num_threads = 0)
+{
+    game::ManualClock clock;
+    game::World world(clock, 1.0 / 60.0, 8, num_threads > 0 ? num_threads : 1);
+    game::AtlasRegion sprites[game::NUM_SPRITES];
+    world.Setup(sprites, 6);
+    world.SetPlayerInvulnerable(true);
+    world.SpawnEnemies(n, 4.0f + 2.0f * sqrt((float) n), 1);
+    world.SetActivityRadius(activity_radius);
+
+    std::string name = (activity_radius > 0.0f) ? "world_step_region/" : "world_step/";
+    name += std::to_string(n);
+    if (num_threads > 0) {
+        name = "world_step_threads/" + std::to_string(n) + "/" + std::to_string(num_threads);
+    }
+    bench.Run(name, world.GetGameObjects().size(), [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++) {
+            world.Step();
+            world.ClearEvents();
+        }
+    });
+}
+
+
+// The Euler step over the entity store
+static void BenchIntegrate(Bench& bench, int n)
+{
+    game::EntityStore store;
+    for (int i = 0; i < n; i++) {
+        int index = store.Create(glm::vec3((float) i, 0.0f, 0.0f), NULL);
+        store.GetVelocity(index) = glm::vec3(1.0f, 0.5f, 0.0f);
+    }
+
+    bench.Run("integrate/" + std::to_string(n), n, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++) {
+            store.Integrate(1.0f / 60.0f);
+        }
+        sink_g = store.GetPosition(0).x;
+    });
+}
+
+
+// Finding what the camera sees among n enemies: indexing them once per step, then one query per frame
+static void BenchCull(Bench& bench, int n)
+{
+    game::ManualClock clock;
+    game::World world(clock);
+    game::AtlasRegion sprites[game::NUM_SPRITES];
+    world.Setup(sprites, 6);
+    world.SpawnEnemies(n, 4.0f + 2.0f * sqrt((float) n), 1);
+    std::vector<game::GameObject*>& objects = world.GetGameObjects();
+
+    game::SpriteCuller culler(4.0f);
+    bench.Run("cull_build/" + std::to_string(n), objects.size(), [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++) {
+            culler.Build(objects);
+        }
+    });
+
+    std::vector<int> visible;
+    bench.Run("cull_query/" + std::to_string(n), objects.size(), [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++) {
+            culler.Query(objects, glm::vec2(0.0f), glm::vec2(4.0f), 0.5f, visible);
+        }
+        sink_g = (float) visible.size();
+    });
+}
+
+
+// One frame of the CPU particle effects with the pool kept full
+static void BenchEmitters(Bench& bench)
+{
+    const int capacity = 16384;
+    game::EmitterManager emitters(capacity, 64);
+    game::EmitterSettings settings = { 60000.0f, 0.0f, 3.14159f, 1.0f, 3.0f, 0.2f, 0.5f };
+    for (int i = 0; i < 32; i++) {
+        emitters.AddEmitter(settings, glm::vec2((float) i, 0.0f), 0.0f);
+    }
+    for (int i = 0; i < 60; i++) {
+        emitters.Update(1.0f / 60.0f);
+    }
+
+    bench.Run("emitters/" + std::to_string(capacity), capacity, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++) {
+            emitters.Update(1.0f / 60.0f);
+        }
+        sink_g = (float) emitters.GetParticles().GetCount();
+    });
+}
+
+
+// Sprite matrix: the direct construction used by the renderer against glm's translate * rotate * scale
+static void BenchSpriteTransform(Bench& bench)
+{
+    bench.Run("sprite_transform/direct", 1, [&](long long iterations) {
+        float sum = 0.0f;
+        for (long long i = 0; i < iterations; i++) {
+            glm::mat4 m = game::BuildSpriteTransform(glm::vec3((float) i, 1.0f, 0.0f), (float) i, 1.5f);
+            sum += m[0][0] + m[3][0];
+        }
+        sink_g = sum;
+    });
+
+    bench.Run("sprite_transform/glm", 1, [&](long long iterations) {
+        float sum = 0.0f;
+        for (long long i = 0; i < iterations; i++) {
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3((float) i, 1.0f, 0.0f)) *
+                          glm::rotate(glm::mat4(1.0f), glm::radians((float) i), glm::vec3(0.0f, 0.0f, 1.0f)) *
+                          glm::scale(glm::mat4(1.0f), glm::vec3(1.5f, 1.5f, 1.5f));
+            sum += m[0][0] + m[3][0];
+        }
+        sink_g = sum;
+    });
+}
+
+
+// Reading a shader source
+static void BenchLoadTextFile(Bench& bench)
+{
+    std::string filename = std::string(RESOURCES_DIRECTORY) + "/instanced_vertex_shader.glsl";
+    bench.Run("load_text_file", 1, [&](long long iterations) {
+        size_t size = 0;
+        for (long long i = 0; i < iterations; i++) {
+            size += game::LoadTextFile(filename.c_str()).size();
+        }
+        sink_g = (float) size;
+    });
+}
+
+
+// Decoding a sprite image, as the atlas packer does for every sprite
+static void BenchTextureDecode(Bench& bench)
+{
+#ifdef YUME_BENCH_SOIL
+    std::string filename = std::string(RESOURCES_DIRECTORY) + "/textures/" + game::sprite_names_g[game::SPRITE_CHOPPER] + ".png";
+    bench.Run("texture_decode", 1, [&](long long iterations) {
+        for (long long i = 0; i < iterations; i++) {
+            int width, height;
+            unsigned char *image = SOIL_load_image(filename.c_str(), &width, &height, 0, SOIL_LOAD_RGBA);
+            if (!image) {
+                throw(std::runtime_error(std::string("Error loading ") + filename + ": " + SOIL_last_result()));
+            }
+            sink_g = image[0];
+            SOIL_free_image_data(image);
+        }
+    });
+#else
+    if (std::string("texture_decode").find(bench.filter) != std::string::npos) {
+        std::cout << "texture_decode skipped, SOIL was not found when configuring" << std::endl;
+    }
+#endif
+}
+
+
+int main(int argc, char **argv){
+    Bench bench;
+    bench.min_time = 0.2;
+    const char *out_filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            bench.filter = argv[++i];
+        }
+        else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            bench.min_time = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_filename = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter text] [--min-time seconds] [--out file]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        BenchRayCircle(bench);
+        int sizes[] = { 10, 100, 1000, 10000 };
+        for (int i = 0; i < 4; i++) {
+            BenchWorldStep(bench, sizes[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            BenchWorldStep(bench, sizes[i], 32.0f);
+        }
+
+        // Scaling from one thread to every core, at the largest size
+        int hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+        int thread_counts[] = { 1, 2, 4, hardware_threads };
+        for (int i = 0; i < 4; i++) {
+            if (i < 3 || hardware_threads > 4) {
+                BenchWorldStep(bench, 10000, 0.0f, thread_counts[i]);
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            BenchIntegrate(bench, sizes[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            BenchCull(bench, sizes[i]);
+        }
+        BenchEmitters(bench);
+        BenchSpriteTransform(bench);
+        BenchLoadTextFile(bench);
+        BenchTextureDecode(bench);
+
+        if (out_filename) {
+            bench.Write(out_filename);
+        }
+    }
+    catch (std::exception &e){
+        // Catch and print any errors
+        PrintException(e);
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,7 +1,6 @@
 #include <string>
 #include <iostream>
 #include "buoy_game_object.h"
-#include <GLFW/glfw3.h>
 
 namespace game {
 
@@ -10,17 +9,19 @@ namespace game {
 		It overrides GameObject's update method, so that you can check for input to change the velocity of the player
 	*/
 
-	BuoyGameObject::BuoyGameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable, float mass)
-		: GameObject(position, texture, num_elements, collidable, mass) {}
+	BuoyGameObject::BuoyGameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable, float mass)
+		: GameObject(store, position, sprite, num_elements, collidable, mass) {
+		type_ = OBJECT_BUOY;
+	}
 
 	// Update function for moving the player object around
-	void BuoyGameObject::Update(double delta_time) {
+	void BuoyGameObject::Update(double delta_time, double current_time) {
 
 		// Special player updates go here
 		
 
 		// Call the parent's update method to move the object in standard way, if desired
-		GameObject::Update(delta_time);
+		GameObject::Update(delta_time, current_time);
 	}
 
 } // namespace game
@@ -0,0 +1,36 @@
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+namespace game {
+
+    // Source of time driving the simulation
+    // The rendered game uses the window library's timer, headless runs advance a ManualClock
+    class Clock {
+
+        public:
+            virtual ~Clock() {}
+
+            // Current time in seconds
+            virtual double GetTime(void) = 0;
+
+    }; // class Clock
+
+    // Clock that only moves when told to
+    class ManualClock : public Clock {
+
+        public:
+            ManualClock(void) : time_(0.0) {}
+
+            double GetTime(void) override { return time_; }
+
+            // Move the clock forward by the given number of seconds
+            inline void Advance(double seconds) { time_ += seconds; }
+
+        private:
+            double time_;
+
+    }; // class ManualClock
+
+} // namespace game
+
+#endif // CLOCK_H_
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cmath>
+
+#include "emitter_manager.h"
+#include "profiler.h"
+
+namespace game {
+
+// Velocity lost per second by the CPU particles
+const float particle_drag_g = 1.5f;
+
+// The budget never drops below this fraction of the capacity
+const float min_budget_fraction_g = 0.125f;
+
+
+EmitterManager::EmitterManager(int capacity, int max_emitters)
+    : particles_(capacity), emitters_(max_emitters), generator_(1)
+{
+    num_emitters_ = 0;
+    budget_ = capacity;
+    min_budget_ = std::max(1, (int) (capacity * min_budget_fraction_g));
+    for (int i = 0; i < max_emitters; i++) {
+        emitters_[i].active = false;
+    }
+}
+
+
+int EmitterManager::AddEmitter(const EmitterSettings& settings, const glm::vec2& position, float direction)
+{
+    for (int i = 0; i < emitters_.size(); i++) {
+        if (!emitters_[i].active) {
+            Emitter& emitter = emitters_[i];
+            emitter.active = true;
+            emitter.settings = settings;
+            emitter.position = position;
+            emitter.direction = direction;
+            emitter.age = 0.0f;
+            emitter.owed = 0.0f;
+            num_emitters_++;
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+void EmitterManager::MoveEmitter(int id, const glm::vec2& position, float direction)
+{
+    if (id >= 0 && emitters_[id].active) {
+        emitters_[id].position = position;
+        emitters_[id].direction = direction;
+    }
+}
+
+
+void EmitterManager::RemoveEmitter(int id)
+{
+    if (id >= 0 && emitters_[id].active) {
+        emitters_[id].active = false;
+        num_emitters_--;
+    }
+}
+
+
+void EmitterManager::Burst(const EmitterSettings& settings, const glm::vec2& position, float direction, int count)
+{
+    // Bursts thin out with the budget like the emitters
+    count = (int) std::ceil(count * (float) budget_ / particles_.GetCapacity());
+    for (int i = 0; i < count; i++) {
+        Spawn(settings, position, direction);
+    }
+}
+
+
+void EmitterManager::Update(float delta_time)
+{
+    YUME_PROFILE_ZONE("EmitterManager::Update");
+    float scale = (float) budget_ / particles_.GetCapacity();
+
+    for (int i = 0; i < emitters_.size(); i++) {
+        Emitter& emitter = emitters_[i];
+        if (!emitter.active) {
+            continue;
+        }
+
+        emitter.owed += emitter.settings.rate * scale * delta_time;
+        int count = (int) emitter.owed;
+        emitter.owed -= count;
+        for (int k = 0; k < count; k++) {
+            Spawn(emitter.settings, emitter.position, emitter.direction);
+        }
+
+        // Emitters with a duration go away by themselves
+        emitter.age += delta_time;
+        if (emitter.settings.duration > 0.0f && emitter.age >= emitter.settings.duration) {
+            RemoveEmitter(i);
+        }
+    }
+
+    particles_.Update(delta_time, particle_drag_g);
+}
+
+
+void EmitterManager::ReportFrameTime(double frame_time, double frame_budget)
+{
+    // Back off quickly when over budget, recover slowly
+    if (frame_time > frame_budget) {
+        budget_ = std::max(min_budget_, (int) (budget_ * 0.8f));
+    }
+    else if (frame_time < 0.9 * frame_budget) {
+        budget_ = std::min(particles_.GetCapacity(), budget_ + std::max(1, particles_.GetCapacity() / 64));
+    }
+}
+
+
+void EmitterManager::Spawn(const EmitterSettings& settings, const glm::vec2& position, float direction)
+{
+    if (particles_.GetCount() >= budget_) {
+        return;
+    }
+
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    float angle = direction + settings.spread * (2.0f * unit(generator_) - 1.0f);
+    float speed = settings.min_speed + (settings.max_speed - settings.min_speed) * unit(generator_);
+    float lifetime = settings.min_lifetime + (settings.max_lifetime - settings.min_lifetime) * unit(generator_);
+    particles_.Spawn(position, speed * glm::vec2(cos(angle), sin(angle)), lifetime);
+}
+
+} // namespace game
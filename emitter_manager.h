@@ -0,0 +1,85 @@
+#ifndef EMITTER_MANAGER_H_
+#define EMITTER_MANAGER_H_
+
+#include <glm/glm.hpp>
+#include <random>
+#include <vector>
+
+#include "particle_pool.h"
+
+namespace game {
+
+    // How an emitter launches its particles, each particle picks its own values within the ranges
+    struct EmitterSettings {
+        float rate;            // Particles per second
+        float duration;        // Seconds the emitter lives, 0 to keep it until it is removed
+        float spread;          // Radians either side of the emitter's direction, pi for every direction
+        float min_speed, max_speed;
+        float min_lifetime, max_lifetime;
+    };
+
+    /*
+        EmitterManager runs the short-lived effects simulated on the CPU: emitters that spawn particles at their rate
+        (an engine, the puff of a kill) and one-shot bursts (a pickup), all sharing one ParticlePool
+        The number of particles alive is held to a budget that shrinks while frames take longer than the frame budget
+        and grows back once they are fast again; emission rates are scaled by it, so every effect thins out evenly
+        instead of some of them disappearing
+    */
+    class EmitterManager {
+
+        public:
+            // capacity is the most particles ever alive, max_emitters the most emitters at once
+            EmitterManager(int capacity, int max_emitters);
+
+            // Add an emitter at position, launching around direction (radians)
+            // Returns its id, or -1 when every emitter slot is taken
+            int AddEmitter(const EmitterSettings& settings, const glm::vec2& position, float direction);
+
+            // Move an emitter, for effects following an object
+            void MoveEmitter(int id, const glm::vec2& position, float direction);
+
+            // Stop an emitter, its particles live on
+            void RemoveEmitter(int id);
+
+            // Spawn count particles at once
+            void Burst(const EmitterSettings& settings, const glm::vec2& position, float direction, int count);
+
+            // Spawn what the emitters owe for delta_time seconds, then age and move every particle
+            void Update(float delta_time);
+
+            // Adapt the particle budget to how long the last frame took, against a target of frame_budget seconds
+            void ReportFrameTime(double frame_time, double frame_budget);
+
+            // Getters
+            inline const ParticlePool& GetParticles(void) const { return particles_; }
+            inline int GetBudget(void) const { return budget_; }
+            inline int GetNumEmitters(void) const { return num_emitters_; }
+
+        private:
+            struct Emitter {
+                bool active;
+                EmitterSettings settings;
+                glm::vec2 position;
+                float direction;
+                float age;
+                float owed; // Fraction of a particle carried over to the next update
+            };
+
+            ParticlePool particles_;
+            std::vector<Emitter> emitters_;
+            int num_emitters_;
+
+            // Most particles alive at once, between a floor and the pool's capacity
+            int budget_;
+            int min_budget_;
+
+            std::mt19937 generator_;
+
+            // Spawn one particle of settings, unless the budget is spent
+            void Spawn(const EmitterSettings& settings, const glm::vec2& position, float direction);
+
+    }; // class EmitterManager
+
+} // namespace game
+
+#endif // EMITTER_MANAGER_H_
@@ -1,7 +1,6 @@
 #include <string>
 #include <iostream>
 #include "enemy_game_object.h"
-#include <GLFW/glfw3.h>
 
 namespace game {
 
@@ -10,16 +9,17 @@ namespace game {
 		It overrides GameObject's update method, so that you can check for input to change the velocity of the player
 	*/
 
-	EnemyGameObject::EnemyGameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable, float mass, std::string state)
-		: GameObject(position, texture, num_elements, collidable, mass, state) {}
+	EnemyGameObject::EnemyGameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable, float mass, std::string state)
+		: GameObject(store, position, sprite, num_elements, collidable, mass, state) {
+		type_ = OBJECT_ENEMY;
+	}
 
 	// Update function for moving the player object around
-	void EnemyGameObject::Update(double delta_time) {
+	void EnemyGameObject::Update(double delta_time, double current_time) {
 
 		// Special player updates go here
 		if (state_ == "patrolling") { //Patrolling
-			double lastTime = glfwGetTime();
-			SetVelocity(glm::vec3(glm::cos(lastTime), glm::sin(lastTime), 0.0f));
+			SetVelocity(glm::vec3(glm::cos(current_time), glm::sin(current_time), 0.0f));
 		}
 		else { //Moving
 			//std::cout << "Moving" << std::endl;
@@ -27,7 +27,19 @@ namespace game {
 		}
 
 		// Call the parent's update method to move the object in standard way, if desired
-		GameObject::Update(delta_time);
+		GameObject::Update(delta_time, current_time);
+	}
+
+	// Land where the patrol would have taken the enemy while it was asleep
+	void EnemyGameObject::FastForward(double start_time, int num_steps, double timestep) {
+		if (state_ == "patrolling" && num_steps > 0) {
+			GetPosition() += PatrolDisplacement(start_time, num_steps, timestep);
+			double last_time = start_time + (num_steps - 1) * timestep;
+			SetVelocity(glm::vec3(glm::cos(last_time), glm::sin(last_time), 0.0f));
+		}
+		else {
+			GameObject::FastForward(start_time, num_steps, timestep);
+		}
 	}
 
 } // namespace game
@@ -0,0 +1,98 @@
+#include "entity_store.h"
+
+namespace game {
+
+EntityStore::EntityStore(void)
+{
+}
+
+
+int EntityStore::Create(const glm::vec3& position, GameObject *owner)
+{
+    int index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    }
+    else {
+        index = position_.size();
+        position_.push_back(glm::vec3(0.0f));
+        velocity_.push_back(glm::vec3(0.0f));
+        angle_.push_back(0.0f);
+        scale_.push_back(1.0f);
+        mass_.push_back(0.0f);
+        collidable_.push_back(0);
+        generation_.push_back(0);
+        owner_.push_back(NULL);
+        previous_position_.push_back(glm::vec3(0.0f));
+        previous_angle_.push_back(0.0f);
+    }
+
+    position_[index] = position;
+    velocity_[index] = glm::vec3(0.0f, 0.0f, 0.0f); // Starts out stationary
+    angle_[index] = 0.0f;
+    scale_[index] = 1.0f;
+    mass_[index] = 0.0f;
+    collidable_[index] = 0;
+    owner_[index] = owner;
+
+    // Nothing to interpolate from before the first step
+    previous_position_[index] = position;
+    previous_angle_[index] = 0.0f;
+    return index;
+}
+
+
+void EntityStore::Reserve(int count)
+{
+    position_.reserve(count);
+    velocity_.reserve(count);
+    angle_.reserve(count);
+    scale_.reserve(count);
+    mass_.reserve(count);
+    collidable_.reserve(count);
+    generation_.reserve(count);
+    owner_.reserve(count);
+    previous_position_.reserve(count);
+    previous_angle_.reserve(count);
+}
+
+
+void EntityStore::Destroy(int index)
+{
+    // A free slot keeps being integrated with the rest, with no velocity it stays put
+    velocity_[index] = glm::vec3(0.0f, 0.0f, 0.0f);
+    collidable_[index] = 0;
+
+    // Outstanding handles to the slot stop resolving
+    generation_[index]++;
+    owner_[index] = NULL;
+    free_.push_back(index);
+}
+
+
+void EntityStore::SaveState(void)
+{
+    // Same sizes every time, so this copies without allocating
+    previous_position_ = position_;
+    previous_angle_ = angle_;
+}
+
+
+void EntityStore::Integrate(float delta_time)
+{
+    Integrate(delta_time, 0, position_.size());
+}
+
+
+void EntityStore::Integrate(float delta_time, int begin, int end)
+{
+    // Free slots are not skipped, a branch per slot costs more than moving them by zero
+    glm::vec3 *position = position_.data();
+    const glm::vec3 *velocity = velocity_.data();
+    for (int i = begin; i < end; i++) {
+        position[i] += velocity[i] * delta_time;
+    }
+}
+
+} // namespace game
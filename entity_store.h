@@ -0,0 +1,103 @@
+#ifndef ENTITY_STORE_H_
+#define ENTITY_STORE_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game {
+
+    class GameObject;
+
+    // Stable reference to an entity: the slot index and the generation of the slot when the reference was taken
+    // A handle to a destroyed entity never resolves, even once its slot is reused
+    struct EntityHandle {
+        int index;
+        unsigned int generation;
+
+        EntityHandle(void) : index(-1), generation(0) {}
+        EntityHandle(int index, unsigned int generation) : index(index), generation(generation) {}
+    };
+
+    /*
+        EntityStore keeps the state that every step reads and writes (position, velocity, angle, scale, mass, collidable)
+        in one contiguous array per field, indexed by entity slot
+        GameObjects are views over a slot, the integration step runs over the arrays in a single pass
+        Slots of destroyed entities are reused, so an index is only meaningful while its GameObject is alive,
+        keep an EntityHandle to refer to an entity across steps
+        References returned by the getters are invalidated when a new entity is created
+    */
+    class EntityStore {
+
+        public:
+            EntityStore(void);
+
+            // Take a slot for a new stationary entity viewed by owner and return its index
+            int Create(const glm::vec3& position, GameObject *owner);
+
+            // Make room for count slots in total, so that creating that many entities does not reallocate
+            void Reserve(int count);
+
+            // Give a slot back, the entity stops moving until the slot is reused and its handles stop resolving
+            void Destroy(int index);
+
+            // Handle to the entity currently in a slot
+            inline EntityHandle GetHandle(int index) const { return EntityHandle(index, generation_[index]); }
+
+            // Whether the handle still refers to a live entity
+            inline bool IsAlive(const EntityHandle& handle) const {
+                return handle.index >= 0 && handle.index < (int) generation_.size() && generation_[handle.index] == handle.generation && owner_[handle.index] != NULL;
+            }
+
+            // Object viewing the entity, NULL if it was destroyed
+            inline GameObject* Resolve(const EntityHandle& handle) const { return IsAlive(handle) ? owner_[handle.index] : NULL; }
+
+            // Remember the position and angle of every slot, called before each step so that the renderer
+            // can interpolate between the last two steps
+            void SaveState(void);
+
+            // Euler step of every slot: position += velocity * delta_time
+            void Integrate(float delta_time);
+
+            // Same over the slots in [begin, end), disjoint ranges can be integrated on different threads
+            void Integrate(float delta_time, int begin, int end);
+
+            // Field access
+            inline glm::vec3& GetPosition(int index) { return position_[index]; }
+            inline glm::vec3& GetVelocity(int index) { return velocity_[index]; }
+            inline float& GetAngle(int index) { return angle_[index]; }
+            inline float& GetScale(int index) { return scale_[index]; }
+            inline float& GetMass(int index) { return mass_[index]; }
+            inline unsigned char& GetCollidable(int index) { return collidable_[index]; }
+
+            // State before the last step, blended with the current one: alpha = 0 is the previous step, 1 the current one
+            inline glm::vec3 GetInterpolatedPosition(int index, float alpha) const { return previous_position_[index] + (position_[index] - previous_position_[index]) * alpha; }
+            inline float GetInterpolatedAngle(int index, float alpha) const { return previous_angle_[index] + (angle_[index] - previous_angle_[index]) * alpha; }
+
+            // Number of slots (alive or free) and of live entities
+            inline int GetNumSlots(void) const { return position_.size(); }
+            inline int GetNumEntities(void) const { return position_.size() - free_.size(); }
+
+        private:
+            std::vector<glm::vec3> position_;
+            std::vector<glm::vec3> velocity_;
+            std::vector<float> angle_;
+            std::vector<float> scale_;
+            std::vector<float> mass_;
+            std::vector<unsigned char> collidable_;
+
+            // Position and angle saved by SaveState(), only read by the renderer
+            std::vector<glm::vec3> previous_position_;
+            std::vector<float> previous_angle_;
+
+            // Bookkeeping of the slots
+            std::vector<unsigned int> generation_;
+            std::vector<GameObject*> owner_;
+
+            // Slots waiting to be reused
+            std::vector<int> free_;
+
+    }; // class EntityStore
+
+} // namespace game
+
+#endif // ENTITY_STORE_H_
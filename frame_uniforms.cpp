@@ -0,0 +1,40 @@
+#include "frame_uniforms.h"
+
+namespace game {
+
+FrameUniforms::FrameUniforms(void)
+{
+    // Don't do work in the constructor, leave it for the Init() function
+    ubo_ = 0;
+}
+
+
+FrameUniforms::~FrameUniforms()
+{
+    if (ubo_) {
+        glDeleteBuffers(1, &ubo_);
+    }
+}
+
+
+void FrameUniforms::Init(void)
+{
+    glGenBuffers(1, &ubo_);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORMS_BINDING, ubo_);
+}
+
+
+void FrameUniforms::Update(const glm::mat4& view_matrix, float time)
+{
+    Block block;
+    block.view_matrix = view_matrix;
+    block.time = time;
+    block.padding[0] = block.padding[1] = block.padding[2] = 0.0f;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+}
+
+} // namespace game
@@ -0,0 +1,45 @@
+#ifndef FRAME_UNIFORMS_H_
+#define FRAME_UNIFORMS_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Binding point of the per-frame uniform block, every program declaring FrameUniforms reads from it
+#define FRAME_UNIFORMS_BINDING 0
+
+    /*
+        FrameUniforms holds the data that is the same for every draw of a frame (view matrix, time)
+        in one uniform buffer shared by all programs, so it is uploaded once per frame instead of once per program or object
+        Programs declare it as:
+            layout(std140) uniform FrameUniforms { mat4 view_matrix; float time; };
+    */
+    class FrameUniforms {
+
+        public:
+            FrameUniforms(void);
+            ~FrameUniforms();
+
+            // Create the buffer and attach it to FRAME_UNIFORMS_BINDING
+            void Init(void);
+
+            // Upload the data of a new frame
+            void Update(const glm::mat4& view_matrix, float time);
+
+        private:
+            // Layout of the block in std140
+            struct Block {
+                glm::mat4 view_matrix;
+                float time;
+                float padding[3];
+            };
+
+            GLuint ubo_;
+
+    }; // class FrameUniforms
+
+} // namespace game
+
+#endif // FRAME_UNIFORMS_H_
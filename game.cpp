@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <glm/glm.hpp>
@@ -9,26 +10,15 @@
 #include <cstdlib>
 #include <math.h>
 #include <utility>
-#include <stack>
-#include <typeinfo>
 
 #include <path_config.h>
 
 #include "shader.h"
-#include "player_game_object.h"
 #include "game.h"
 #include "audio_manager.h"
-#include "enemy_game_object.h"
-#include "shield_game_object.h"
 #include "game_object.h"
-#include "buoy_game_object.h"
-#include "shield_power_up.h"
-#include "background_game_object.h"
-#include "seeker_game_object.h"
-#include "star_power_up.h"
-#include "penguin_game_object.h"
-#include "arrow_power_up.h"
-#include "arrow_game_object.h"
+#include "profiler.h"
+#include "shield_game_object.h"
 
 #include "bin/path_config.h"
 #include "glm/ext.hpp"
@@ -47,24 +37,46 @@ const unsigned int window_width_g = 800;
 const unsigned int window_height_g = 600;
 const glm::vec3 viewport_background_color_g(0.0, 0.0, 1.0);
 
+// Simulation rate, independent of the frame rate, and the most steps run to catch up in a single frame
+const double sim_tick_rate_g = 60.0;
+const int max_substeps_g = 5;
+
+// Objects farther than this from the player sleep, well beyond the camera and the reach of an arrow
+const float activity_radius_g = 32.0f;
+
+// Longest the game keeps running once it is over, so that the explosion can play out (sound and particles) before the window closes
+const double game_over_grace_g = 5.0;
+
+// Threads the simulation may use, 0 for every hardware thread
+const int sim_threads_g = 0;
+
+// Zoom of the view, it shows the world within 1 / camera_zoom_g of the camera along each axis
+// SpriteBatch spreads the sprites over that much depth, change its budget with it
+const float camera_zoom_g = 0.25f;
+
+// Particles alive at once on the GPU, the oldest make room for new bursts
+const int particle_capacity_g = 1 << 18;
+
+// Bursts: particle count, spread (radians either side), speed range and lifetime range
+const ParticleBurst player_explosion_g = { 20000, glm::pi<float>(), 0.5f, 6.0f, 0.5f, 1.5f };
+const ParticleBurst enemy_explosion_g = { 4000, glm::pi<float>(), 0.5f, 4.0f, 0.3f, 1.0f };
+
+// Particles simulated on the CPU alive at once, and emitters running at once
+const int cpu_particle_capacity_g = 16384;
+const int max_emitters_g = 64;
+
+// Work a frame may take before the CPU particles thin out, in seconds, leaving room in a 60 Hz frame for the swap
+const double frame_budget_g = 0.012;
+
+// CPU effects: rate, duration, spread (radians either side), speed range and lifetime range
+const EmitterSettings trail_g = { 3000.0f, 0.0f, 0.25f, 1.0f, 2.5f, 0.2f, 0.5f };
+const EmitterSettings kill_smoke_g = { 2000.0f, 0.4f, glm::pi<float>(), 0.2f, 1.0f, 0.4f, 0.8f };
+const EmitterSettings pickup_g = { 0.0f, 0.0f, glm::pi<float>(), 1.0f, 3.0f, 0.2f, 0.4f };
+const int pickup_count_g = 300;
+
+// Trace written when F9 is pressed and at exit in profiling builds
+const char *profile_filename_g = "yume_trace.json";
 
-bool game_over = false;
-bool bulletExists = false;
-bool shielded = false;
-bool invincible = false;
-bool frozen = false;
-bool arrowPowerUp = false;
-bool arrowExists = false;
-unsigned int audio_loops = 0;
-double lastBulletFired = -1.0;
-float timeUntilBulletHitsEnemy = 1.0f;
-unsigned int numNonCollidableObjects = 13;
-unsigned int numPowerUps = 2;
-unsigned int numEnemies = 5;
-unsigned int numBuoys = 2;
-double lastInvincible = 0.0;
-double lastFrozen = 0.0;
-double lastArrow = 0.0;
 
 //Camera
 glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 1.0f);
@@ -76,8 +88,22 @@ const std::string resources_directory_g = RESOURCES_DIRECTORY;
 
 
 Game::Game(void)
+    : emitters_(cpu_particle_capacity_g, max_emitters_g), world_(clock_, 1.0 / sim_tick_rate_g, max_substeps_g, sim_threads_g),
+      culler_(1.0f / camera_zoom_g)
 {
     // Don't do work in the constructor, leave it for the Init() function
+    explosion_sound_ = -1;
+    render_alpha_ = 0.0f;
+    profile_key_down_ = false;
+    culled_step_ = 0;
+    num_frames_ = 0;
+    num_visible_total_ = 0;
+    num_draw_calls_total_ = 0;
+    last_frame_time_ = 0.0;
+    trail_emitter_ = -1;
+    replaying_ = false;
+    effects_end_ = 0.0;
+    level_filename_ = std::string(BUILD_DIRECTORY) + std::string("/level1.lvl");
 }
 
 
@@ -94,14 +120,14 @@ void Game::Init(void)
     glfwWindowHint(GLFW_RESIZABLE, GL_FALSE); 
 
     // Create a window and its OpenGL context
-    window_ = glfwCreateWindow(window_width_g, window_height_g, window_title_g, NULL, NULL);
-    if (!window_) {
+    window_.Set(glfwCreateWindow(window_width_g, window_height_g, window_title_g, NULL, NULL));
+    if (!window_.Get()) {
         glfwTerminate();
         throw(std::runtime_error(std::string("Could not create window")));
     }
 
     // Make the window's OpenGL context the current one
-    glfwMakeContextCurrent(window_);
+    glfwMakeContextCurrent(window_.Get());
 
     // Initialize the GLEW library to access OpenGL extensions
     // Need to do it after initializing an OpenGL context
@@ -111,17 +137,59 @@ void Game::Init(void)
         throw(std::runtime_error(std::string("Could not initialize the GLEW library: ") + std::string((const char *)glewGetErrorString(err))));
     }
 
+    // Instanced sprite rendering needs OpenGL 3.3
+    if (!GLEW_VERSION_3_3) {
+        throw(std::runtime_error(std::string("OpenGL 3.3 is required")));
+    }
+
     // Set event callbacks
-    glfwSetFramebufferSizeCallback(window_, ResizeCallback);
+    glfwSetFramebufferSizeCallback(window_.Get(), ResizeCallback);
 
     // Set up square geometry
     size_ = CreateSprite();
 
+    // Let the driver compile on as many threads as it likes, every program is handed over before any is waited for
+    double shader_start = glfwGetTime();
+    if (GLEW_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+    else if (GLEW_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    }
+    program_cache_.Init(std::string(BUILD_DIRECTORY));
+    shader_ = LoadShader(resources_directory_g + std::string("/instanced_vertex_shader.glsl"), resources_directory_g + std::string("/instanced_fragment_shader.glsl"));
+    background_shader_ = LoadShader(resources_directory_g + std::string("/background_vertex_shader.glsl"), resources_directory_g + std::string("/background_fragment_shader.glsl"));
+    particle_update_shader_ = LoadShader(resources_directory_g + std::string("/particle_update_shader.glsl"), "", ParticleEngine::GetFeedbackVaryings());
+    particle_draw_shader_ = LoadShader(resources_directory_g + std::string("/particle_draw_vertex_shader.glsl"), resources_directory_g + std::string("/particle_draw_fragment_shader.glsl"));
+    shader_->Finish();
+    background_shader_->Finish();
+    particle_update_shader_->Finish();
+    particle_draw_shader_->Finish();
+
+    // Cold starts compile every program, warm starts load them all from the cache
+    std::cout << "Shaders ready in " << (glfwGetTime() - shader_start) * 1000.0 << " ms: " << program_cache_.GetNumHits() << " from the program cache, "
+              << program_cache_.GetNumMisses() << " compiled" << (program_cache_.IsEnabled() ? "" : " (no program binary support)") << std::endl;
+
     // Initialize shader
-    shader_.Init((resources_directory_g+std::string("/vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/fragment_shader.glsl")).c_str());
-    shader_.CreateSprite();
-    shader_.Enable();
-    shader_.SetSpriteAttributes();
+    shader_->CreateSprite();
+    shader_->Enable();
+    shader_->SetSpriteAttributes();
+
+    // Per-frame data lives in one uniform buffer shared by the programs
+    frame_uniforms_.Init();
+    shader_->BindUniformBlock("FrameUniforms", FRAME_UNIFORMS_BINDING);
+
+    // All sprites are drawn through the batch
+    sprite_batch_.Init(*shader_, shader_->GetSpriteSize());
+
+    // The backdrop is one screen-covering draw
+    background_shader_->BindUniformBlock("FrameUniforms", FRAME_UNIFORMS_BINDING);
+    background_.Init(*background_shader_);
+
+    // Particles never leave the GPU: one program steps them through transform feedback, the other draws them
+    particle_draw_shader_->BindUniformBlock("FrameUniforms", FRAME_UNIFORMS_BINDING);
+    particles_.Init(*particle_update_shader_, *particle_draw_shader_, particle_capacity_g);
+    particle_stream_.Init(*particle_draw_shader_, cpu_particle_capacity_g);
 
     // Set up z-buffer for rendering
     glEnable(GL_DEPTH_TEST);
@@ -130,14 +198,36 @@ void Game::Init(void)
     // Enable Alpha blending
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Sounds are decoded now so playing them later costs nothing
+    InitAudio();
 }
 
 
 Game::~Game()
 {
+    // window_ is destroyed after the members, with the context they release their OpenGL objects in
+}
+
 
-    glfwDestroyWindow(window_);
-    glfwTerminate();
+void Game::RecordInput(const std::string& filename)
+{
+    record_filename_ = filename;
+    input_log_.SetSetup(1.0 / sim_tick_rate_g, 0, 1, false, activity_radius_g);
+}
+
+
+void Game::ReplayInput(const std::string& filename)
+{
+    input_log_.Load(filename);
+    if (input_log_.GetTimestep() != 1.0 / sim_tick_rate_g) {
+        throw(std::runtime_error(std::string("Input log ") + filename + " was recorded with another timestep, replay it with yume_headless"));
+    }
+    replaying_ = true;
+
+    // The window's frame rate no longer matters: one tick per frame, without waiting for the display
+    clock_.SetFixedStep(input_log_.GetTimestep());
+    glfwSwapInterval(0);
 }
 
 
@@ -145,128 +235,148 @@ void Game::Setup(void)
 {
 
     // Load textures
-    SetAllTextures();
-
-    // Setup the player object (position, texture, vertex count)
-    // Note that, in this specific implementation, the player object should always be the first object in the game object vector 
-    game_objects_.push_back(new PlayerGameObject(glm::vec3(0.0f, 0.0f, 0.0f), tex_[0], size_, true));
-    game_objects_[0]->SetMass(10.0f);
-
-    // Blades as children of PlayerGameObject
-    game_objects_[0]->AddChild(new PlayerGameObject(glm::vec3(0.0f, 0.0f, 0.0f), tex_[4], size_, false));
-
-    // Enemies
-    game_objects_.push_back(new EnemyGameObject(glm::vec3(-3.0f, 4.0f, 0.0f), tex_[2], size_, true, 10.0f, "patrolling"));
-    game_objects_.push_back(new EnemyGameObject(glm::vec3(3.0f, -2.0f, 0.0f), tex_[2], size_, true, 10.0f, "patrolling"));
-    game_objects_.push_back(new EnemyGameObject(glm::vec3(0.8f, 1.5f, 0.0f), tex_[2], size_, true, 10.0f, "patrolling"));
-
-    // Shield power ups
-    game_objects_.push_back(new ShieldPowerUp(glm::vec3(3.0f, 1.0f, 0.0f), tex_[7], size_, false));
-    game_objects_.push_back(new ShieldPowerUp(glm::vec3(-2.0f, -1.0f, 0.0f), tex_[7], size_, false));
-
-    // Star power ups
-    game_objects_.push_back(new StarPowerUp(glm::vec3(3.0f, 3.0f, 0.0f), tex_[10], size_, false));
-    game_objects_.push_back(new StarPowerUp(glm::vec3(-2.0f, -3.0f, 0.0f), tex_[10], size_, false));
-
-    // Buoys
-    //game_objects_.push_back(new BuoyGameObject(glm::vec3(2.0f, 0.0f, 0.0f), tex_[8], size_, true, 10.0f));
-    //game_objects_.push_back(new BuoyGameObject(glm::vec3(-2.0f, 1.0f, 0.0f), tex_[8], size_, true, 20.0f));
-
-    // Arrow power up
-    game_objects_.push_back(new ArrowPowerUp(glm::vec3(-4.0f, -3.0f, 0.0f), tex_[12], size_, false));
-
-    // Seekers
-    game_objects_.push_back(new SeekerGameObject(glm::vec3(3.0f, -2.0f, 0.0f), tex_[9], size_, true, 5.0f, "moving"));
-    game_objects_.push_back(new SeekerGameObject(glm::vec3(-4.0f, 2.0f, 0.0f), tex_[9], size_, true, 5.0f, "moving"));
-
-    // Penguins
-    game_objects_.push_back(new PenguinGameObject(glm::vec3(0.0f, 5.0f, 0.0f), tex_[11], size_, false, 5.0f, "patrolling"));
-    game_objects_.push_back(new PenguinGameObject(glm::vec3(0.0f, -5.0f, 0.0f), tex_[11], size_, false, 5.0f, "patrolling"));
-
-    // Setup background
-    // Origin
-    GameObject *background = new BackgroundGameObject(glm::vec3(0.0f, 0.0f, 0.0f), tex_[3], size_, false);
-    background->SetScale(10.0);
-    game_objects_.push_back(background);
-
-    //Top Left
-    GameObject* background2 = new BackgroundGameObject(glm::vec3(-10.0f, 10.0f, 0.0f), tex_[3], size_, false);
-    background2->SetScale(10.0);
-    game_objects_.push_back(background2);
-
-    //Top Middle
-    GameObject* background3 = new BackgroundGameObject(glm::vec3(0.0f, 10.0f, 0.0f), tex_[3], size_, false);
-    background3->SetScale(10.0);
-    game_objects_.push_back(background3);
-
-    //Top Right
-    GameObject* background4 = new BackgroundGameObject(glm::vec3(10.0f, 10.0f, 0.0f), tex_[3], size_, false);
-    background4->SetScale(10.0);
-    game_objects_.push_back(background4);
-
-    //Middle Left
-    GameObject* background5 = new BackgroundGameObject(glm::vec3(-10.0f, 0.0f, 0.0f), tex_[3], size_, false);
-    background5->SetScale(10.0);
-    game_objects_.push_back(background5);
-
-    //Middle Right
-    GameObject* background6 = new BackgroundGameObject(glm::vec3(10.0f, 0.0f, 0.0f), tex_[3], size_, false);
-    background6->SetScale(10.0);
-    game_objects_.push_back(background6);
-
-    //Bottom Left
-    GameObject* background7 = new BackgroundGameObject(glm::vec3(-10.0f, -10.0f, 0.0f), tex_[3], size_, false);
-    background7->SetScale(10.0);
-    game_objects_.push_back(background7);
-
-    //Bottom Middle
-    GameObject* background8 = new BackgroundGameObject(glm::vec3(0.0f, -10.0f, 0.0f), tex_[3], size_, false);
-    background8->SetScale(10.0);
-    game_objects_.push_back(background8);
-
-    //Bottom Right
-    GameObject* background9 = new BackgroundGameObject(glm::vec3(10.0f, -10.0f, 0.0f), tex_[3], size_, false);
-    background9->SetScale(10.0);
-    game_objects_.push_back(background9);
-
+    LoadSprites();
+
+    // Space, one tile every 10 units in every direction
+    background_.AddLayer(sprites_[SPRITE_SPACE], 10.0f);
+
+    // Create the scene, the world copies what it needs out of the level
+    Level level;
+    level.Load(level_filename_);
+    world_.Setup(sprites_, size_, &level);
+    world_.SetActivityRadius(activity_radius_g);
+    if (replaying_ && input_log_.GetLevelHash() != level.GetHash()) {
+        throw(std::runtime_error(std::string("The input log was recorded on another level than ") + level_filename_));
+    }
+    input_log_.SetLevelHash(level.GetHash());
+
+    // Hook the input log up, a replay also brings back the setup it was recorded with
+    if (replaying_) {
+        world_.SpawnEnemies(input_log_.GetNumEnemies(), 4.0f + 2.0f * sqrt((float) input_log_.GetNumEnemies()), input_log_.GetSeed());
+        world_.SetPlayerInvulnerable(input_log_.IsInvulnerable());
+        world_.SetActivityRadius(input_log_.GetActivityRadius());
+        world_.ReplayInput(&input_log_);
+    }
+    else if (!record_filename_.empty()) {
+        world_.RecordInput(&input_log_);
+    }
 }
 
 
 void Game::MainLoop(void) {
+    last_frame_time_ = clock_.GetTime();
+    double replay_start = glfwGetTime();
+
+    double game_over_time = -1.0;
+
+    // Loop while the user did not close the window, until the game is over and done showing it
+    while (!glfwWindowShouldClose(window_.Get())) {
+        YUME_PROFILE_ZONE("Frame");
+        double frame_start = glfwGetTime();
+
+        // Once the game is over keep drawing the end of it, the loop is left when the explosion is over
+        if (world_.IsOver()) {
+            if (game_over_time < 0.0) {
+                game_over_time = frame_start;
+            }
+            if (!IsGameOverPlaying(frame_start - game_over_time)) {
+                break;
+            }
+        }
+
+        // A replay ends with its log
+        if (replaying_) {
+            if (world_.GetNumSteps() >= input_log_.GetNumTicks()) {
+                break;
+            }
+            clock_.Tick();
+        }
 
-    // Loop while the user did not close the window
-    double lastTime = glfwGetTime();
-    
-    while (!glfwWindowShouldClose(window_)){
         // Clear background
         glClearColor(viewport_background_color_g.r,
                      viewport_background_color_g.g,
                      viewport_background_color_g.b, 0.0);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Set view to zoom out, centered by default at 0,0
-        float cameraZoom = 0.25f;
+        // Upload the sprites that finished loading
+        atlas_->Update();
 
-        cameraPos = game_objects_[0]->GetPosition();
+        // Handle user input
+        Controls();
 
-        glm::mat4 view_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(cameraZoom, cameraZoom, cameraZoom)) * glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        // Step the simulation up to the current time, and draw it where it is between its last two steps
+        world_.Advance();
+        HandleEvents();
+        render_alpha_ = world_.GetInterpolationAlpha();
 
-        shader_.SetUniformMat4("view_matrix", view_matrix);
+        // Particles are only for show, they step with the frame rather than the simulation
+        double now = clock_.GetTime();
+        float frame_time = (float) (now - last_frame_time_);
+        last_frame_time_ = now;
+        UpdateTrail();
+        emitters_.Update(frame_time);
+        particles_.Update(frame_time);
 
-        // Calculate delta time
-        double currentTime = glfwGetTime();
-        double deltaTime = currentTime - lastTime;
-        lastTime = currentTime;
+        // Set view to zoom out, centered by default at 0,0
+        cameraPos = world_.GetPlayer()->GetInterpolatedPosition(render_alpha_);
+
+        glm::mat4 view_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(camera_zoom_g, camera_zoom_g, camera_zoom_g)) * glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+
+        frame_uniforms_.Update(view_matrix, world_.GetTime());
 
-        // Update the game
-        Update(deltaTime);
+        // Draw the game
+        Render();
+        num_frames_++;
+        num_visible_total_ += GetNumVisibleSprites();
+        num_draw_calls_total_ += GetNumDrawCalls();
+
+        // The CPU particles thin out while frames take too long, except in replays which must do the same work every time
+        if (!replaying_) {
+            emitters_.ReportFrameTime(glfwGetTime() - frame_start, frame_budget_g);
+        }
 
         // Push buffer drawn in the background onto the display
-        glfwSwapBuffers(window_);
+        {
+            YUME_PROFILE_ZONE("SwapBuffers");
+            glfwSwapBuffers(window_.Get());
+        }
 
         // Update other events like input handling
         glfwPollEvents();
     }
+
+    if (num_frames_ > 0) {
+        std::cout << "Drew " << num_frames_ << " frames: " << (double) num_visible_total_ / num_frames_ << " objects visible and "
+                  << (double) num_draw_calls_total_ / num_frames_ << " sprite draw calls per frame on average" << std::endl;
+    }
+    if (replaying_) {
+        std::cout << "Replayed " << world_.GetNumSteps() << " ticks in " << glfwGetTime() - replay_start << " s" << std::endl;
+    }
+    if (!record_filename_.empty()) {
+        try {
+            input_log_.Save(record_filename_);
+            std::cout << "Input recorded to " << record_filename_ << std::endl;
+        }
+        catch (std::exception& e) {
+            PrintException(e);
+        }
+    }
+
+    DumpProfile();
+}
+
+
+void Game::DumpProfile(void)
+{
+#ifdef YUME_PROFILE
+    try {
+        Profiler::Dump(profile_filename_g);
+        std::cout << "Profile written to " << profile_filename_g << std::endl;
+    }
+    catch (std::exception& e) {
+        PrintException(e);
+    }
+#endif
 }
 
 
@@ -321,524 +431,263 @@ int Game::CreateSprite(void)
 }
 
 
-void Game::SetTexture(GLuint w, const char *fname)
+void Game::LoadSprites(void)
 {
-    // Bind texture buffer
-    glBindTexture(GL_TEXTURE_2D, w);
-
-    // Load texture from a file to the buffer
-    int width, height;
-    unsigned char* image = SOIL_load_image(fname, &width, &height, 0, SOIL_LOAD_RGBA);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-    SOIL_free_image_data(image);
-
-    // Texture Wrapping
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-    // Texture Filtering
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // All sprites come from one file packed at build time (see atlas_packer.cpp)
+    // Only the names are read here, the pixels keep arriving during the first frames
+    atlas_ = LoadAtlas(std::string(BUILD_DIRECTORY) + std::string("/sprites.pak"));
+    for (int i = 0; i < NUM_SPRITES; i++) {
+        sprites_[i] = atlas_->GetRegion(sprite_names_g[i]);
+    }
 }
 
 
-void Game::SetAllTextures(void)
+std::shared_ptr<Shader> Game::LoadShader(const std::string& vertex_path, const std::string& fragment_path, const std::vector<std::string>& feedback_varyings)
 {
-    // Load all textures that we will need
-    glGenTextures(NUM_TEXTURES, tex_);
-    SetTexture(tex_[0], (resources_directory_g + std::string("/textures/chopper.png")).c_str());
-    SetTexture(tex_[1], (resources_directory_g + std::string("/textures/alien.png")).c_str());
-    SetTexture(tex_[2], (resources_directory_g + std::string("/textures/alien.png")).c_str());
-    SetTexture(tex_[3], (resources_directory_g + std::string("/textures/space.png")).c_str());
-    SetTexture(tex_[4], (resources_directory_g + std::string("/textures/blade.png")).c_str());
-    SetTexture(tex_[5], (resources_directory_g + std::string("/textures/bullet.png")).c_str());
-    SetTexture(tex_[6], (resources_directory_g + std::string("/textures/orb.png")).c_str());
-    SetTexture(tex_[7], (resources_directory_g + std::string("/textures/shield.png")).c_str());
-    SetTexture(tex_[8], (resources_directory_g + std::string("/textures/donut.png")).c_str());
-    SetTexture(tex_[9], (resources_directory_g + std::string("/textures/clown.png")).c_str());
-    SetTexture(tex_[10], (resources_directory_g + std::string("/textures/star.png")).c_str());
-    SetTexture(tex_[11], (resources_directory_g + std::string("/textures/penguin.png")).c_str());
-    SetTexture(tex_[12], (resources_directory_g + std::string("/textures/bow.png")).c_str());
-    SetTexture(tex_[13], (resources_directory_g + std::string("/textures/arrow.png")).c_str());
-    glBindTexture(GL_TEXTURE_2D, tex_[0]);
-}
-
-
-void Game::Controls(void) {
-
-    // Get player game object
-    GameObject *player = game_objects_[0];
-    GameObject *blades = player->GetChildren()[0];
-    glm::vec3 curpos = player->GetPosition();
-    glm::vec3 curvel = player->GetVelocity();
-
-    //float deg_angle = glm::angle(glm::normalize(curpos), glm::vec3(1.0f, 0.0f, 0.0f));
-    float deg_angle = player->GetAngle() + 90;
-    float angle = glm::radians(deg_angle);
-
-    // Check for player input and make changes accordingly
-    if (glfwGetKey(window_, GLFW_KEY_W) == GLFW_PRESS) {
-        player->SetVelocity(curvel + glm::vec3(0.05*glm::cos(angle), 0.05*glm::sin(angle), 0.0f));
-    }
-    if (glfwGetKey(window_, GLFW_KEY_S) == GLFW_PRESS) {
-        player->SetVelocity(curvel - glm::vec3(0.05*glm::cos(angle), 0.05*glm::sin(angle), 0.0f));
-    }
-    if (glfwGetKey(window_, GLFW_KEY_D) == GLFW_PRESS) {
-        player->SetAngle(player->GetAngle() - 0.02f);
-        blades->SetAngle(blades->GetAngle() - 0.02f);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_A) == GLFW_PRESS) {
-        player->SetAngle(player->GetAngle() + 0.02f);
-        blades->SetAngle(blades->GetAngle() + 0.02f);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_Q) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window_, true);
-    }
-    if (glfwGetKey(window_, GLFW_KEY_V) == GLFW_PRESS) {
-        if (arrowPowerUp) {
-            std::cout << "Should be making an arrow now" << std::endl;
-            /*GameObject* arrow = new ArrowGameObject(glm::vec3(player->GetPosition()), tex_[13], size_, false);
-            float angle = player->GetAngle() + 90.0;
-            //std::cout << "supposed velocity: " << glm::to_string(2.5f * player->GetVelocity()) << std::endl;
-            glm::vec3 arrowVelocity = glm::vec3(8 * glm::cos(glm::radians(angle)), 8 * glm::sin(glm::radians(angle)), 0.0);
-            arrow->SetVelocity(arrowVelocity, true);
-            arrow->SetAngle(player->GetAngle());
-            arrowPowerUp = false;
-            arrowExists = true;
-            game_objects_.push_back(arrow);*/
-            GameObject* arrow = new GameObject(glm::vec3(player->GetPosition()), tex_[13], size_, false);
-            arrow->SetPosition(player->GetPosition());
-            float angle = player->GetAngle() + 90.0;
-            //std::cout << "supposed velocity: " << glm::to_string(2.5f * player->GetVelocity()) << std::endl;
-            glm::vec3 arrowVelocity = glm::vec3(8 * glm::cos(glm::radians(angle)), 8 * glm::sin(glm::radians(angle)), 0.0);
-            arrow->SetVelocity(arrowVelocity, true);
-            arrow->SetAngle(player->GetAngle());
-            player->AddArrow(arrow);
-            arrowPowerUp = false;
-            arrowExists = true;
-            lastArrow = glfwGetTime();
-            std::cout << "successfully made arrow" << std::endl;
-        }
-    }
-    
-    if (glfwGetKey(window_, GLFW_KEY_SPACE) == GLFW_PRESS) {
-        double currentTime = glfwGetTime();
-        double bulletDifference = currentTime - lastBulletFired;
-
-        if (bulletDifference >= 1.0 && !bulletExists) {
-            // Bullet
-            std::cout << "Should be making a bullet now" << std::endl;
-            GameObject* bullet = new GameObject(glm::vec3(player->GetPosition()), tex_[5], size_, false);
-            bullet->SetPosition(player->GetPosition());
-            float angle = player->GetAngle() + 90.0;
-            //std::cout << "supposed velocity: " << glm::to_string(2.5f * player->GetVelocity()) << std::endl;
-            glm::vec3 bulletVelocity = glm::vec3(8 * glm::cos(glm::radians(angle)), 8 * glm::sin(glm::radians(angle)), 0.0);
-            bullet->SetVelocity(bulletVelocity, true);
-            bullet->SetAngle(player->GetAngle());
-            player->AddBullet(bullet);
-            lastBulletFired = currentTime;
-            bulletExists = true;
-        }
+    // The captured outputs are part of the program, the same sources with other outputs are another program
+    std::string key = vertex_path + "|" + fragment_path;
+    for (int i = 0; i < feedback_varyings.size(); i++) {
+        key += "|" + feedback_varyings[i];
     }
+    return shaders_.Get(key, [&] {
+        std::unique_ptr<Shader> shader(new Shader());
+        shader->Begin(vertex_path.c_str(), fragment_path.empty() ? NULL : fragment_path.c_str(), feedback_varyings, &program_cache_);
+        return shader.release();
+    });
 }
 
 
-void Game::PlayExplosionAudio(void) {
-    audio_manager::AudioManager am;
-   
-    // Reference index of each file to be played
-    int explosion_index;
-
-    try {
-        // Initialize audio manager
-        am.Init(NULL);
+std::shared_ptr<TextureAtlas> Game::LoadAtlas(const std::string& path)
+{
+    return atlases_.Get(path, [&] {
+        std::unique_ptr<TextureAtlas> atlas(new TextureAtlas());
+        atlas->Load(path.c_str());
+        return atlas.release();
+    });
+}
 
-        // Set position of listener
-        am.SetListenerPosition(0.0, 0.0, 0.0);
 
-        // Load first sound to be played
-        std::string filename = std::string(resources_directory_g).append(std::string("/").append(std::string("explosion.wav")));
-        explosion_index = am.AddSound(filename.c_str());
-        // Set sound properties
-        am.SetSoundPosition(explosion_index, -10.0, 0.0, 0.0);
-        am.SetLoop(explosion_index, false);
-        // Play the sound
-        am.PlaySound(explosion_index);
-
-        // Keep program running while something is being played
-        while (am.AnySoundIsPlaying()) {
-            ;
-        }
-        //audio_loops++;
-        // Shut down the audio manager
-        am.ShutDown();
-        //if (audio_loops >= 2) {
-        //    exit(0);
-        //}
-        //exit(0);
+void Game::Controls(void) {
+    YUME_PROFILE_ZONE("Game::Controls");
+
+    // Check for player input and hand it to the world
+    PlayerInput input;
+    input.forward = glfwGetKey(window_.Get(), GLFW_KEY_W) == GLFW_PRESS;
+    input.backward = glfwGetKey(window_.Get(), GLFW_KEY_S) == GLFW_PRESS;
+    input.turn_right = glfwGetKey(window_.Get(), GLFW_KEY_D) == GLFW_PRESS;
+    input.turn_left = glfwGetKey(window_.Get(), GLFW_KEY_A) == GLFW_PRESS;
+    input.fire_arrow = glfwGetKey(window_.Get(), GLFW_KEY_V) == GLFW_PRESS;
+    input.fire_bullet = glfwGetKey(window_.Get(), GLFW_KEY_SPACE) == GLFW_PRESS;
+    world_.SetInput(input);
+
+    if (glfwGetKey(window_.Get(), GLFW_KEY_Q) == GLFW_PRESS) {
+        glfwSetWindowShouldClose(window_.Get(), true);
     }
-    catch (std::exception& e) {
-        PrintException(e);
+
+    // Dump the profile once per press
+    bool profile_key_down = glfwGetKey(window_.Get(), GLFW_KEY_F9) == GLFW_PRESS;
+    if (profile_key_down && !profile_key_down_) {
+        DumpProfile();
     }
+    profile_key_down_ = profile_key_down;
 }
 
-glm::vec3 Game::GetVectorBetweenTwoPoints(glm::vec3 start, glm::vec3 destination) {
 
-    return(glm::normalize(glm::vec3(destination.x - start.x, destination.y - start.y, 0)));
-}
-
-std::pair<float, float> Game::RayCircleCollisionMath(glm::vec3 bulletPosition, glm::vec3 bulletVelocity, glm::vec3 circlePosition) {
-    float w = bulletPosition.x; //P.x
-    float x = bulletVelocity.x; //d.x
-    float y = bulletPosition.y; //P.y
-    float z = bulletVelocity.y; //d.y
-    float r = 0.5f;
-    float a = circlePosition.x;
-    float b = circlePosition.y;
-
-    float leftSide = -x*w+a*x-y*z+b*z;
-    float discriminant = sqrt(x*x*r*r+2*b*x*x*y-b*b*x*x-x*x*y*y+2*a*b*x*z+2*x*y*z*w-2*a*x*y*z-2*b*x*z*w+2*a*z*z*w+z*z*r*r-a*a*z*z-z*z*w*w);
-    float divisor = x * x + z * z;
-
-    float t1 = (leftSide + discriminant) / divisor;
-    float t2 = (leftSide - discriminant) / divisor;
-
-    std::pair<float, float> pair;
-    pair.first = t1;
-    pair.second = t2;
-    return pair;
-}
+void Game::HandleEvents(void) {
 
-void Game::createShields(glm::vec3 curpos) {
-    GameObject* player = game_objects_[0];
-    player->AddShield(new ShieldGameObject(glm::vec3(curpos.x, curpos.y + 1.0f, 0.0f), tex_[6], size_, false));
-    player->AddShield(new ShieldGameObject(glm::vec3(curpos.x + 1.0f, curpos.y - 0.5f, 0.0f), tex_[6], size_, false));
-    player->AddShield(new ShieldGameObject(glm::vec3(curpos.x - 1.0f, curpos.y - 0.5f, 0.0f), tex_[6], size_, false));
-    player->AddShield(new ShieldGameObject(glm::vec3(curpos.x - 1.0f, curpos.y - 0.5f, 0.0f), tex_[6], size_, false));
-    player->AddShield(new ShieldGameObject(glm::vec3(curpos.x - 1.0f, curpos.y - 0.5f, 0.0f), tex_[6], size_, false));
-    player->AddShield(new ShieldGameObject(glm::vec3(curpos.x - 1.0f, curpos.y - 0.5f, 0.0f), tex_[6], size_, false));
+    const std::vector<WorldEvent>& events = world_.GetEvents();
+    for (int i = 0; i < events.size(); i++) {
+        if (events[i].type == WorldEventType::PlayerExploded) {
+            // The world already switched the sprites to the explosion, add the sound without waiting for it
+            try {
+                audio_.PlayOneShot(explosion_sound_, -10.0, 0.0, 0.0);
+            }
+            catch (std::exception& e) {
+                PrintException(e);
+            }
+            particles_.Emit(player_explosion_g, glm::vec2(events[i].position), 0.0f);
+            effects_end_ = std::max(effects_end_, clock_.GetTime() + player_explosion_g.max_lifetime);
+        }
+        else if (events[i].type == WorldEventType::EnemyKilled) {
+            particles_.Emit(enemy_explosion_g, glm::vec2(events[i].position), 0.0f);
+            effects_end_ = std::max(effects_end_, clock_.GetTime() + enemy_explosion_g.max_lifetime);
+            emitters_.AddEmitter(kill_smoke_g, glm::vec2(events[i].position), 0.0f);
+        }
+        else if (events[i].type == WorldEventType::PowerUpCollected) {
+            emitters_.Burst(pickup_g, glm::vec2(events[i].position), 0.0f, pickup_count_g);
+        }
+    }
+    world_.ClearEvents();
 }
 
-void Game::renderBlades(void) {
-    GameObject* player = game_objects_[0];
-    GameObject* blades = player->GetChildren()[0];
-    blades->SetAngle(blades->GetAngle() + 0.3f);
-    blades->Render(shader_, player->GetTransformationMatrix());
-}
 
-void Game::bulletUpdate(void) {
-    GameObject* bullet = game_objects_[0]->GetBullet()[0];
-    double currentTime = glfwGetTime();
-    double bulletDifference = currentTime - lastBulletFired;
-    int enemyToDelete = 0;
-    float timeUntilBulletHitsEnemy = 1.0f;
-    // These bounds are for checking the bullet
-
-
-    // Perform Ray-Circle Collision detection
-    // Loop through each enemy to check for collision
-    for (int i = 0; i < game_objects_.size(); i++) {
-        GameObject* circle = game_objects_[i];
-        if (typeid(*circle) == typeid(SeekerGameObject) || typeid(*circle) == typeid(EnemyGameObject)) {
-            std::pair<float, float> pair = RayCircleCollisionMath(bullet->GetPosition(), bullet->GetVelocity(), circle->GetPosition());
-            if (pair.first >= 0 || pair.second >= 0) {
-                if (std::min(pair.first, pair.second) < timeUntilBulletHitsEnemy) {
-                    timeUntilBulletHitsEnemy = std::min(pair.first, pair.second);
-                    enemyToDelete = i;
-                }
-            }
-        }
-        
+bool Game::IsGameOverPlaying(double elapsed) {
+    if (elapsed >= game_over_grace_g) {
+        return false;
     }
 
-    if (currentTime >= lastBulletFired + timeUntilBulletHitsEnemy && enemyToDelete != 0) { // If enough time has passed (enemy hit is assumed)
-        game_objects_.erase(game_objects_.begin() + enemyToDelete);
-        game_objects_[0]->DeleteBullet();
-        lastBulletFired = -1.5;
-        bulletExists = false;
-        numEnemies--;
+    // The last explosions are still flying
+    if (clock_.GetTime() < effects_end_) {
+        return true;
     }
 
-    // Check if it's been 1.5 seconds since last bullet was fired
-    // If so, then we can delete the bullet from the child vector
-    if (bulletDifference >= 1.0) {
-        game_objects_[0]->DeleteBullet();
-        lastBulletFired = -1.5;
-        bulletExists = false;
+    // Sounds are fire-and-forget, leaving now would cut them off when the audio device shuts down
+    try {
+        return audio_.AnySoundIsPlaying();
+    }
+    catch (std::exception& e) {
+        PrintException(e);
+        return false;
     }
 }
 
-void Game::arrowUpdate(void) {
-    std::cout << "updating arrow" << std::endl;
-    GameObject* arrow = game_objects_[0]->GetArrow()[0];
-    int enemyToDelete = 0;
 
-    if(glfwGetTime() - lastArrow >= 3.0){
-        game_objects_[0]->DeleteArrow();
-        arrowExists = false;
+void Game::UpdateTrail(void) {
+    GameObject* player = world_.GetPlayer();
+    glm::vec2 velocity(player->GetVelocity());
+    float speed = glm::length(velocity);
+    if (speed < 0.01f) {
+        emitters_.RemoveEmitter(trail_emitter_);
+        trail_emitter_ = -1;
         return;
     }
 
-    // Loop through each enemy to check for collision
-    for (int i = 0; i < game_objects_.size(); i++) {
-        GameObject* obj = game_objects_[i];
-        float distance = glm::length(arrow->GetPosition() - obj->GetPosition());
-        if (distance <= 1.0) {
-            if (typeid(*obj) == typeid(SeekerGameObject) || typeid(*obj) == typeid(EnemyGameObject)) {
-                enemyToDelete = i;
-                game_objects_.erase(game_objects_.begin() + enemyToDelete);
-                break;
-            }
-        }   
+    // Out of the back of the chopper, opposite to where it is heading
+    glm::vec2 backwards = -velocity / speed;
+    glm::vec2 position = glm::vec2(player->GetInterpolatedPosition(render_alpha_)) + 0.4f * backwards;
+    float direction = atan2(backwards.y, backwards.x);
+    if (trail_emitter_ < 0) {
+        trail_emitter_ = emitters_.AddEmitter(trail_g, position, direction);
     }
-    
-    std::cout << "done updating arrow" << std::endl;
-}
-
-void Game::renderBullet(double delta_time) {
-    GameObject* bullet = game_objects_[0]->GetBullet()[0];
-    bullet->Update(delta_time);
-    bullet->Render(shader_);
-}
-
-void Game::renderArrow(double delta_time) {
-    std::cout << "rendering arrow" << std::endl;
-    GameObject* arrow = game_objects_[0]->GetArrow()[0];
-    arrow->Update(delta_time);
-    arrow->Render(shader_);
-    std::cout << "done rendering arrow" << std::endl;
-}
-
-void Game::renderShields(double delta_time) {
-    GameObject* player = game_objects_[0];
-    for (int k = 0; k < player->GetShields().size(); k++) {
-        GameObject* shield = player->GetShields()[k];
-        float lastTime = glfwGetTime();
-        shield->SetVelocity(glm::vec3(glm::cos(lastTime + k), glm::sin(lastTime + k), 0.0f));
-        //std::cout << "shield velocity: " << glm::to_string(shield->GetVelocity()) << std::endl;
-        shield->Update(delta_time);
-
-        glm::mat4 around = glm::translate(glm::mat4(1.0f), shield->GetVelocity());
-        //glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), shield->GetPosition());
-        glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(shield->GetScale(), shield->GetScale(), 1.0));
-
-        shield->Render(shader_, player->GetMovementMatrix() * around * scaling_matrix);
+    else {
+        emitters_.MoveEmitter(trail_emitter_, position, direction);
     }
 }
 
-void Game::buoyCollision(GameObject* object, GameObject* buoy) {
-    glm::vec3 n = glm::normalize(object->GetPosition() - buoy->GetPosition());
-    glm::vec3 v1 = object->GetVelocity();
-    glm::vec3 v2 = buoy->GetVelocity();
-
-    float m1 = object->GetMass();
-    float m2 = buoy->GetMass();
 
-    glm::vec3 v1prime = v1 - ((2 * m2) / (m1 + m2)) * (glm::dot(n, v1 - v2)) * n;
-    glm::vec3 v2prime = v2 - ((2 * m1) / (m1 + m2)) * (glm::dot(n, v2 - v1)) * n;
+void Game::InitAudio(void) {
 
-    object->SetVelocity(v1prime);
-    buoy->SetVelocity(v2prime);
-}
+    try {
+        // Initialize audio manager
+        audio_.Init(NULL);
 
-void Game::Update(double delta_time) {
+        // Set position of listener
+        audio_.SetListenerPosition(0.0, 0.0, 0.0);
 
-    // Handle user input
-    if (!game_over && !frozen) {
-        Controls();
+        // Load every sound to be played
+        std::string filename = std::string(resources_directory_g).append(std::string("/").append(std::string("explosion.wav")));
+        explosion_sound_ = audio_.AddSound(filename.c_str());
     }
-    if(game_over || numEnemies == 0){
-        exit(0);
+    catch (std::exception& e) {
+        PrintException(e);
+        explosion_sound_ = -1;
     }
+}
 
-    // Update and render all game objects
-    for (int i = 0; i < game_objects_.size(); i++) {
-        // Get the current game object
-        GameObject* current_game_object = game_objects_[i];
-
-        // Update the current game object
-        current_game_object->Update(delta_time);
+void Game::RenderGameObject(GameObject* object) {
+    YUME_PROFILE_ZONE("Game::RenderGameObject");
 
-        // Check for collision with other game objects
-        for (int j = i + 1; j < game_objects_.size(); j++) {
-            GameObject* other_game_object = game_objects_[j];
+    // Setup the transformation matrix for the shader
+    glm::mat4 transformation_matrix = BuildSpriteTransform(object->GetInterpolatedPosition(render_alpha_), object->GetInterpolatedAngle(render_alpha_), object->GetScale());
 
-            // Collision detection between player and enemies
-            float distance = glm::length(current_game_object->GetPosition() - other_game_object->GetPosition());
+    // Save it for heirarchical transformations
+    object->SetTransformationMatrix(transformation_matrix);
 
-            // Player/Enemy interaction (Moving/Patrolling)
-            if(typeid(*current_game_object) == typeid(PlayerGameObject) && typeid(*other_game_object) == typeid(EnemyGameObject)){
-                if (distance < 1.5f) {
-                    other_game_object->SetState("moving");
-                    glm::vec3 resultantVector = GetVectorBetweenTwoPoints(other_game_object->GetPosition(), current_game_object->GetPosition());
+    // Queue the entity
+    sprite_batch_.Add(atlas_->GetTexture(), object->GetSprite().layer, transformation_matrix);
+}
 
-                    float angle = glm::angle(resultantVector, glm::normalize(glm::vec3(1.0f, 0.0f, 0.0f)));
+void Game::RenderGameObject(GameObject* object, glm::mat4 ParentTransformation) {
+    YUME_PROFILE_ZONE("Game::RenderGameObject");
 
-                    // Enemy state = moving
-                    other_game_object->SetVelocity(glm::vec3(resultantVector.x, resultantVector.y, 0.0f));
-                    other_game_object->SetAngle(angle + 90);
-                }
-                else {
-                    other_game_object->SetState("patrolling");
-                }
-            }
-            else if (typeid(*current_game_object) == typeid(PlayerGameObject) && typeid(*other_game_object) == typeid(SeekerGameObject)) {
-                glm::vec3 resultantVector = GetVectorBetweenTwoPoints(other_game_object->GetPosition(), current_game_object->GetPosition());
+    glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0), object->GetInterpolatedAngle(render_alpha_), glm::vec3(0, 0, 1));
 
-                float angle = glm::angle(resultantVector, glm::normalize(glm::vec3(1.0f, 0.0f, 0.0f)));
-
-                other_game_object->SetVelocity(glm::vec3(resultantVector.x, resultantVector.y, 0.0f));
-                other_game_object->SetAngle(angle + 90);
-            }
-            else if (typeid(*current_game_object) == typeid(PlayerGameObject) && typeid(*other_game_object) == typeid(PenguinGameObject)) {
-                if (distance < 1.5f) {
-                    other_game_object->SetState("moving");
-                    glm::vec3 resultantVector = GetVectorBetweenTwoPoints(other_game_object->GetPosition(), current_game_object->GetPosition());
-
-                    float angle = glm::angle(resultantVector, glm::normalize(glm::vec3(1.0f, 0.0f, 0.0f)));
-
-                    // Enemy state = moving
-                    other_game_object->SetVelocity(glm::vec3(resultantVector.x, resultantVector.y, 0.0f));
-                    other_game_object->SetAngle(angle + 90);
-                }
-                else {
-                    other_game_object->SetState("patrolling");
-                }
-            }
+    // Setup the transformation matrix for the shader
+    glm::mat4 transformation_matrix = ParentTransformation * rotation_matrix;
 
+    // Queue the entity
+    sprite_batch_.Add(atlas_->GetTexture(), object->GetSprite().layer, transformation_matrix);
+}
 
-            if (distance < 1.0f && current_game_object->GetCollidable() && other_game_object->GetCollidable()) {
-                if (typeid(*other_game_object) != typeid(BuoyGameObject)) { // Not a buoy so can apply destruction logic
-                    if (!shielded && i == 0) { // Not shielded
-                        
-                        std::cout << "currentgameobject collidable is " << current_game_object->GetCollidable() << std::endl;
-                        std::cout << "Explode";
-                        game_over = true;
-                        SetTexture(tex_[0], (resources_directory_g + std::string("/textures/explosion.png")).c_str()); //Player
-                        SetTexture(tex_[1], (resources_directory_g + std::string("/textures/explosion.png")).c_str()); //Enemy 1
-                        SetTexture(tex_[2], (resources_directory_g + std::string("/textures/explosion.png")).c_str()); //Enemy 2
-
-                        current_game_object->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
-                        other_game_object->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
-
-                        // Add the sound
-                        PlayExplosionAudio();
-                    }
-                    else { // Shielded
-                        if (i == 0) {
-                            //std::cout << "collided with enemy but shielded" << std::endl;
-                            game_objects_.erase(game_objects_.begin() + j);
-                            current_game_object->RemoveShields();
-                            shielded = false;
-                            numEnemies--;
-                            continue;
-                        }
-                    }
-                }
-                else { // It's a buoy so have appropriate collision response
-                    //std::cout << "It's a buoy" << std::endl;
-                    GameObject* buoy = other_game_object;
-                    buoyCollision(current_game_object, buoy);
-                }
-            }
+void Game::renderBlades(void) {
+    GameObject* player = world_.GetPlayer();
+    GameObject* blades = player->GetChildren()[0];
+    RenderGameObject(blades, player->GetTransformationMatrix());
+}
 
-            // Checking for collision of power up
-            if (typeid(*current_game_object) == typeid(PlayerGameObject) && typeid(*other_game_object) == typeid(ShieldPowerUp)) {
-                if (distance < 1.0f) {
-                    //std::cout << "collided with shield" << std::endl;
-                    glm::vec3 curpos = current_game_object->GetPosition();
-                    
-                    game_objects_.erase(game_objects_.begin() + j); // Erases the power up
-
-                    if (!shielded) {
-                        createShields(curpos);
-
-                        for (int k = 0; k < current_game_object->GetShields().size(); k++) {
-                            GameObject* shield = current_game_object->GetShields()[k];
-                            shield->SetScale(0.25f);
-                        }
-                        shielded = true;
-                    }
-                }
-            }
-            else if (typeid(*current_game_object) == typeid(PlayerGameObject) && typeid(*other_game_object) == typeid(StarPowerUp)) {
-                if (distance < 1.0f) {
-                    //std::cout << "collided with star" << std::endl;
-                    glm::vec3 curpos = current_game_object->GetPosition();
+void Game::renderProjectiles(void) {
+    YUME_PROFILE_ZONE("Game::renderProjectiles");
+    const ProjectilePool& projectiles = world_.GetProjectiles();
+
+    // Projectiles fly straight, so their position between steps follows from their velocity
+    float behind = (float) world_.GetTimestep() * (1.0f - render_alpha_);
+    glm::vec2 half_extent(1.0f / camera_zoom_g);
+    for (int i = 0; i < projectiles.GetCount(); i++) {
+        glm::vec3 position = projectiles.GetPosition(i) - projectiles.GetVelocity(i) * behind;
+        if (!SpriteCuller::Overlaps(position, 1.0f, glm::vec2(cameraPos), half_extent)) {
+            continue;
+        }
+        SpriteId sprite = (projectiles.GetKind(i) == PROJECTILE_ARROW) ? SPRITE_ARROW : SPRITE_BULLET;
+        sprite_batch_.Add(atlas_->GetTexture(), sprites_[sprite].layer, BuildSpriteTransform(position, projectiles.GetAngle(i), 1.0f));
+    }
+}
 
-                    game_objects_.erase(game_objects_.begin() + j); // Erases the power up
+void Game::renderShields(void) {
+    YUME_PROFILE_ZONE("Game::renderShields");
+    GameObject* player = world_.GetPlayer();
+    for (int k = 0; k < player->GetShields().size(); k++) {
+        ShieldGameObject* shield = static_cast<ShieldGameObject*>(player->GetShields()[k]);
 
-                    current_game_object->SetCollidable(false);
-                    lastInvincible = glfwGetTime();
-                    invincible = true;
+        // Drawn at its orbit offset from where the player is drawn
+        glm::mat4 movement_matrix = BuildSpriteTransform(player->GetInterpolatedPosition(render_alpha_), player->GetInterpolatedAngle(render_alpha_), 1.0f);
+        glm::mat4 around = glm::translate(glm::mat4(1.0f), shield->GetOrbitOffset());
+        glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(shield->GetScale(), shield->GetScale(), 1.0));
 
-                }
-            }
-            else if (typeid(*current_game_object) == typeid(PlayerGameObject) && typeid(*other_game_object) == typeid(PenguinGameObject)) {
-                if (distance < 1.0f) {
-                    game_objects_.erase(game_objects_.begin() + j); // Erases the penguin
-                    lastFrozen = glfwGetTime();
-                    frozen = true;
-                    current_game_object->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
-                }
-            }
-            else if (typeid(*current_game_object) == typeid(PlayerGameObject) && typeid(*other_game_object) == typeid(ArrowPowerUp)) {
-                if (distance < 1.0f) {
-                    game_objects_.erase(game_objects_.begin() + j); // Erases the power up
-                    arrowPowerUp = true;
-                }
-            }
+        RenderGameObject(shield, movement_matrix * around * scaling_matrix);
+    }
+}
 
-        }
+void Game::Render(void) {
+    YUME_PROFILE_ZONE("Game::Render");
 
-        // Render game object
-        current_game_object->Render(shader_);
+    // Backdrop first, the sprites are drawn over it
+    background_.Render(atlas_->GetTexture(), cameraPos);
 
+    std::vector<GameObject*>& game_objects = world_.GetGameObjects();
 
-        // 'Parent' Main sprite object
-        if (i == 0) {
-            // Render the blades
-            renderBlades();
+    // Objects only move in simulation steps, frames in between reuse the index
+    if (world_.GetNumSteps() != culled_step_ || game_objects.size() != culler_.GetNumObjects()) {
+        culler_.Build(game_objects);
+        culled_step_ = world_.GetNumSteps();
+    }
+    culler_.Query(game_objects, glm::vec2(cameraPos), glm::vec2(1.0f / camera_zoom_g), render_alpha_, visible_);
 
-            // Render the shields (if exists)
-            if (!current_game_object->GetShields().empty()) {
-                renderShields(delta_time);
-            }
-            if (bulletExists) {
-                renderBullet(delta_time);
-            }
-            if (arrowExists) {
-                renderArrow(delta_time);
-            }
+    // 'Parent' Main sprite object, the camera follows it so it is always on screen
+    GameObject* player = world_.GetPlayer();
+    RenderGameObject(player);
 
-            double currentTime = glfwGetTime();
-            double invincibleDifference = currentTime - lastInvincible;
-            double frozenDifference = currentTime - lastFrozen;
+    // Render the blades
+    renderBlades();
 
-            if (invincible) {
-                if (invincibleDifference >= 5.0) {
-                    current_game_object->SetCollidable(true);
-                    invincible = false;
-                }
-            }
-            if (frozen) {
-                if (frozenDifference >= 3.0) {
-                    frozen = false;
-                }
-            }
-        }
+    // Render the shields (if exists)
+    if (!player->GetShields().empty()) {
+        renderShields();
+    }
+    renderProjectiles();
 
-        // If bullet exists, update and check for collisions
-        if (bulletExists) {
-            bulletUpdate();
+    // Then whatever else is on screen, in the world's order
+    for (int k = 0; k < visible_.size(); k++) {
+        if (visible_[k] != 0) {
+            RenderGameObject(game_objects[visible_[k]]);
         }
+    }
 
-        
+    // Draw everything that was queued
+    sprite_batch_.Flush();
 
-    }
-    if (arrowExists) {
-        arrowUpdate();
-    }
+    // Glow over the sprites
+    particles_.Render();
+    particle_stream_.Render(emitters_.GetParticles());
 }
-       
+
 } // namespace game
@@ -4,14 +4,73 @@
 #define GLEW_STATIC
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "shader.h"
+#include "program_cache.h"
+#include "frame_uniforms.h"
+#include "sprite_batch.h"
+#include "scrolling_background.h"
+#include "sprite_culler.h"
+#include "particle_engine.h"
+#include "particle_stream.h"
+#include "emitter_manager.h"
+#include "texture_atlas.h"
 #include "game_object.h"
+#include "clock.h"
+#include "world.h"
+#include "audio_manager.h"
+#include "resource_cache.h"
+#include "input_log.h"
 
 namespace game {
 
+    // Clock reading the GLFW timer, or in fixed-step mode moving by a set amount once per frame (replays)
+    class GlfwClock : public Clock {
+
+        public:
+            GlfwClock(void) : fixed_step_(0.0), time_(0.0) {}
+
+            double GetTime(void) override { return fixed_step_ > 0.0 ? time_ : glfwGetTime(); }
+
+            // Stop following the timer, from now on the clock only moves by step seconds at every Tick()
+            inline void SetFixedStep(double step) { fixed_step_ = step; }
+            inline void Tick(void) { time_ += fixed_step_; }
+
+        private:
+            double fixed_step_;
+            double time_;
+
+    }; // class GlfwClock
+
+    // Owner of the GLFW window, destroys it and shuts GLFW down when it goes
+    // Game declares it before every member holding OpenGL objects, so that the context outlives them
+    class GlfwWindow {
+
+        public:
+            GlfwWindow(void) : window_(NULL) {}
+            ~GlfwWindow() {
+                if (window_) {
+                    glfwDestroyWindow(window_);
+                }
+                glfwTerminate();
+            }
+
+            inline void Set(GLFWwindow *window) { window_ = window; }
+            inline GLFWwindow* Get(void) const { return window_; }
+
+        private:
+            GLFWwindow *window_;
+
+            GlfwWindow(const GlfwWindow&);
+            GlfwWindow& operator=(const GlfwWindow&);
+
+    }; // class GlfwWindow
+
     // A class for holding the main game objects
+    // The game is a windowed front-end over the World: it feeds the input in and draws the result
     class Game {
 
         public:
@@ -21,30 +80,108 @@ namespace game {
 
             // Call Init() before calling any other method
             // Initialize graphics libraries and main window
-            void Init(void); 
+            void Init(void);
+
+            // Call either before Setup() to record the input of the game to a log,
+            // or to play a log back instead of reading the keyboard, one tick per frame as fast as possible
+            void RecordInput(const std::string& filename);
+            void ReplayInput(const std::string& filename);
+
+            // Call before Setup() to play another level file than the one built from levels/level1.txt
+            inline void SetLevel(const std::string& filename) { level_filename_ = filename; }
 
             // Set up the game (scene, game objects, etc.)
             void Setup(void);
 
             // Run the game (keep the game active)
-            void MainLoop(void); 
+            void MainLoop(void);
+
+            // World objects that survived culling against the camera rectangle in the last frame, the player included
+            // Blades, shields and projectiles are drawn without culling and not counted
+            inline int GetNumVisibleSprites(void) const { return (int) visible_.size(); }
+
+            // Draw calls the sprites of the last frame took
+            inline int GetNumDrawCalls(void) const { return sprite_batch_.GetNumDrawCalls(); }
 
         private:
-            // Main window: pointer to the GLFW window structure
-            GLFWwindow *window_;
+            // Main window, declared first so that it is destroyed last
+            GlfwWindow window_;
+
+            // Shaders and sprite atlases, loaded once per path however many times they are asked for
+            ResourceCache<Shader> shaders_;
+            ResourceCache<TextureAtlas> atlases_;
+
+            // Linked programs kept on disk between runs
+            ProgramCache program_cache_;
 
             // Shader for rendering the scene
-            Shader shader_;
+            std::shared_ptr<Shader> shader_;
+
+            // View matrix and time, uploaded once per frame for every program
+            FrameUniforms frame_uniforms_;
+
+            // Collects the sprites of a frame into instanced draws
+            SpriteBatch sprite_batch_;
+
+            // Backdrop tiled endlessly behind the sprites, with its own program
+            std::shared_ptr<Shader> background_shader_;
+            ScrollingBackground background_;
+
+            // Explosions, simulated and drawn on the GPU by their own programs
+            std::shared_ptr<Shader> particle_update_shader_;
+            std::shared_ptr<Shader> particle_draw_shader_;
+            ParticleEngine particles_;
+
+            // Small effects simulated on the CPU (engine trail, smoke of a kill, pickups), streamed to the same draw program
+            EmitterManager emitters_;
+            ParticleStream particle_stream_;
+            int trail_emitter_;
+
+            // Clock reading of the last frame, the particles step by the real time between frames
+            double last_frame_time_;
 
             // Size of geometry to be rendered
             int size_;
 
-            // References to textures
-#define NUM_TEXTURES 14
-            GLuint tex_[NUM_TEXTURES];
+            // Every sprite of the game in one array texture, and the region of each SpriteId
+            std::shared_ptr<TextureAtlas> atlas_;
+            AtlasRegion sprites_[NUM_SPRITES];
+
+            // Audio device, open for the whole game, and the sounds loaded into it
+            audio_manager::AudioManager audio_;
+            int explosion_sound_;
+
+            // Simulation driven by the window timer
+            GlfwClock clock_;
+            World world_;
+
+            // Where the frame being drawn falls between the last two simulation steps, in [0, 1)
+            float render_alpha_;
 
-            // List of game objects
-            std::vector<GameObject*> game_objects_;
+            // Objects are drawn only if their sprite overlaps the camera rectangle
+            // The index is rebuilt once per simulation step, visible_ holds the objects found for the current frame
+            SpriteCuller culler_;
+            unsigned long long culled_step_;
+            std::vector<int> visible_;
+
+            // Totals over the frames drawn, printed when the game ends
+            unsigned long long num_frames_;
+            unsigned long long num_visible_total_;
+            unsigned long long num_draw_calls_total_;
+
+            // Level file the scene is created from
+            std::string level_filename_;
+
+            // Input being recorded to record_filename_, or played back
+            InputLog input_log_;
+            std::string record_filename_;
+            bool replaying_;
+
+            // Clock time when the particle bursts emitted so far have all died out
+            double effects_end_;
+
+            // Whether the profile dump key was down last frame
+            bool profile_key_down_;
 
             // Callback for when the window is resized
             static void ResizeCallback(GLFWwindow* window, int width, int height);
@@ -52,40 +189,46 @@ namespace game {
             // Create a square for drawing textures
             int CreateSprite(void);
 
-            // Set a specific texture
-            void SetTexture(GLuint w, const char *fname);
+            // Load the packed sprite atlas
+            void LoadSprites(void);
 
-            // Load all textures
-            void SetAllTextures();
+            // Handles to a shader program and a sprite atlas, read from disk only if no handle to them is alive
+            // A transform feedback program has no fragment path and names the outputs it captures
+            // A new program is only begun, call Shader::Finish() before using it
+            std::shared_ptr<Shader> LoadShader(const std::string& vertex_path, const std::string& fragment_path, const std::vector<std::string>& feedback_varyings = std::vector<std::string>());
+            std::shared_ptr<TextureAtlas> LoadAtlas(const std::string& path);
 
-            // Handle user input
+            // Read the user input and hand it to the world
             void Controls(void);
 
-            // Update the game based on user input and simulation
-            void Update(double delta_time);
+            // React to what happened in the world since the last frame
+            void HandleEvents(void);
 
-            void PlayExplosionAudio(void);
+            // Whether the end of the game is still playing, elapsed seconds after it ended
+            bool IsGameOverPlaying(double elapsed);
 
-            glm::vec3 GetVectorBetweenTwoPoints(glm::vec3 start, glm::vec3 destination);
+            // Keep the engine trail behind the player, emitting only while it moves
+            void UpdateTrail(void);
 
-            std::pair<float, float> Game::RayCircleCollisionMath(glm::vec3 bulletPosition, glm::vec3 bulletVelocity, glm::vec3 circlePosition);
+            // Draw every game object
+            void Render(void);
 
-            void createShields(glm::vec3 curpos);
+            // Queue a single game object for drawing, on its own or relative to a parent transformation
+            void RenderGameObject(GameObject* object);
+            void RenderGameObject(GameObject* object, glm::mat4 ParentTransformation);
 
-            void renderBlades(void);
-
-            void bulletUpdate(void);
-
-            void arrowUpdate(void);
+            // Open the audio device and load the sounds, the game runs silent if that fails
+            void InitAudio(void);
 
-            void renderBullet(double delta_time);
+            // Write the profiler trace, does nothing unless built with YUME_PROFILE
+            void DumpProfile(void);
 
-            void renderArrow(double delta_time);
-
-            void renderShields(double delta_time);
+            void renderBlades(void);
 
-            void buoyCollision(GameObject* object, GameObject* buoy);
+            // Queue every bullet and arrow in flight
+            void renderProjectiles(void);
 
+            void renderShields(void);
 
     }; // class Game
 
@@ -1,124 +1,125 @@
-#include <glm/gtc/matrix_transform.hpp>
-#include "glm/ext.hpp"
+#include <cmath>
 #include <iostream>
 
 #include "game_object.h"
 
 namespace game {
 
-GameObject::GameObject(const glm::vec3& position, GLuint texture)
+GameObject::GameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite)
 {
 
-    // Initialize all attributes
-    position_ = position;
-    scale_ = 1.0;
-    angle_ = 0.0f;
-    velocity_ = glm::vec3(0.0f, 0.0f, 0.0f); // Starts out stationary
-    texture_ = texture;
-    collidable_ = false;
+    // Initialize all attributes, the entity starts out stationary
+    store_ = &store;
+    index_ = store.Create(position, this);
+    sprite_ = sprite;
+    type_ = OBJECT_GENERIC;
+    pending_destroy_ = false;
+    dormant_ = false;
 }
 
-GameObject::GameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable)
+GameObject::GameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable)
 {
-    // Initialize all attributes
-    position_ = position;
-    scale_ = 1.0;
-    velocity_ = glm::vec3(0.0f, 0.0f, 0.0f); // Starts out stationary
+    // Initialize all attributes, the entity starts out stationary
+    store_ = &store;
+    index_ = store.Create(position, this);
+    store.GetCollidable(index_) = collidable;
     num_elements_ = num_elements;
-    texture_ = texture;
-    collidable_ = collidable;
-    angle_ = 0.0f;
-    mass_ = 0.0f;
+    sprite_ = sprite;
+    type_ = OBJECT_GENERIC;
+    pending_destroy_ = false;
+    dormant_ = false;
 }
 
-GameObject::GameObject(const glm::vec3 &position, GLuint texture, GLint num_elements, bool collidable, float mass) 
+GameObject::GameObject(EntityStore& store, const glm::vec3 &position, const AtlasRegion& sprite, int num_elements, bool collidable, float mass) 
 {
-    // Initialize all attributes
-    position_ = position;
-    scale_ = 1.0;
-    velocity_ = glm::vec3(0.0f, 0.0f, 0.0f); // Starts out stationary
+    // Initialize all attributes, the entity starts out stationary
+    store_ = &store;
+    index_ = store.Create(position, this);
+    store.GetCollidable(index_) = collidable;
+    store.GetMass(index_) = mass;
     num_elements_ = num_elements;
-    texture_ = texture;
-    collidable_ = collidable;
-    angle_ = 0.0f;
-    mass_ = mass;
+    sprite_ = sprite;
+    type_ = OBJECT_GENERIC;
+    pending_destroy_ = false;
+    dormant_ = false;
 }
 
-GameObject::GameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable, float mass, std::string state)
+GameObject::GameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable, float mass, std::string state)
 {
-    // Initialize all attributes
-    position_ = position;
-    scale_ = 1.0;
-    velocity_ = glm::vec3(0.0f, 0.0f, 0.0f); // Starts out stationary
+    // Initialize all attributes, the entity starts out stationary
+    store_ = &store;
+    index_ = store.Create(position, this);
+    store.GetCollidable(index_) = collidable;
+    store.GetMass(index_) = mass;
     num_elements_ = num_elements;
-    texture_ = texture;
-    collidable_ = collidable;
+    sprite_ = sprite;
+    type_ = OBJECT_GENERIC;
+    pending_destroy_ = false;
+    dormant_ = false;
     state_ = state;
-    angle_ = 0.0f;
-    mass_ = mass;
 }
 
 
-void GameObject::Update(double delta_time) {
+GameObject::~GameObject()
+{
+    // Attachments belong to the object
+    for (int i = 0; i < children_.size(); i++) {
+        delete children_[i];
+    }
+    RemoveShields();
+
+    store_->Destroy(index_);
+}
+
+
+void GameObject::Update(double delta_time, double current_time) {
 
-    // Update object position with Euler integration
-    position_ += velocity_ * ((float) delta_time);
+    // Moving the object is done for every entity at once, see EntityStore::Integrate
 }
 
 
-void GameObject::Render(Shader &shader) {
+void GameObject::Sleep(unsigned long long step, double time) {
+    dormant_ = true;
+    dormant_step_ = step;
+    dormant_time_ = time;
 
-    // Bind the entity's texture
-    glBindTexture(GL_TEXTURE_2D, texture_);
+    // Integration keeps running over every entity, without velocity it leaves this one in place
+    dormant_velocity_ = GetVelocity();
+    SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f), true);
+}
 
-    // Setup the scaling matrix for the shader
-    glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_, scale_, 1.0));
 
-    // Set up the translation matrix for the shader
-    glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
+void GameObject::Wake(unsigned long long step, double timestep) {
+    dormant_ = false;
+    SetVelocity(dormant_velocity_, true);
+    FastForward(dormant_time_, (int) (step - dormant_step_), timestep);
+}
 
-    // TODO: Add other types of transformations
-    glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0), angle_, glm::vec3(0, 0, 1));
 
-    // Setup the transformation matrix for the shader
-    glm::mat4 transformation_matrix = translation_matrix * rotation_matrix * scaling_matrix;
+void GameObject::FastForward(double start_time, int num_steps, double timestep) {
+    GetPosition() += GetVelocity() * (float) (num_steps * timestep);
+}
 
-    // Save these for heirarchical transformations
-    transformation_matrix_ = transformation_matrix;
-    rotation_matrix_ = rotation_matrix;
-    translation_matrix_ = translation_matrix;
-    movement_matrix_ = translation_matrix * rotation_matrix;
 
-    // Set the transformation matrix in the shader
-    shader.SetUniformMat4("transformation_matrix", transformation_matrix);
+glm::vec3 GameObject::PatrolDisplacement(double start_time, int num_steps, double timestep) {
+    if (num_steps <= 0) {
+        return glm::vec3(0.0f, 0.0f, 0.0f);
+    }
 
-    // Draw the entity
-    glDrawElements(GL_TRIANGLES, num_elements_, GL_UNSIGNED_INT, 0);
+    // Sum of a sampled sinusoid: sum_k cos(a + k d) = sin(n d / 2) / sin(d / 2) * cos(a + (n - 1) d / 2), same for sin
+    double half_step = 0.5 * timestep;
+    double gain = timestep * sin(num_steps * half_step) / sin(half_step);
+    double middle = start_time + (num_steps - 1) * half_step;
+    return glm::vec3((float) (gain * cos(middle)), (float) (gain * sin(middle)), 0.0f);
 }
 
-void GameObject::Render(Shader& shader, glm::mat4 ParentTransformation){
-    // Bind the entity's texture
-    glBindTexture(GL_TEXTURE_2D, texture_);
-    /*
-    // Setup the scaling matrix for the shader
-    glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_, scale_, 1.0));
-
-    // Set up the translation matrix for the shader
-    glm::mat4 translation_matrix = glm::translate(glm::mat4(1.0f), position_);
-    */
-    // TODO: Add other types of transformations
-    glm::mat4 rotation_matrix = glm::rotate(glm::mat4(1.0), angle_, glm::vec3(0, 0, 1));
-
-    // Setup the transformation matrix for the shader
-    glm::mat4 transformation_matrix = ParentTransformation * rotation_matrix;
-    //std::cout << "trans matrix: " << glm::to_string(transformation_matrix) << std::endl;
-    //transformation_matrix_ = transformation_matrix;
-
-    // Set the transformation matrix in the shader
-    shader.SetUniformMat4("transformation_matrix", transformation_matrix);
-
-    // Draw the entity
-    glDrawElements(GL_TRIANGLES, num_elements_, GL_UNSIGNED_INT, 0);
+
+void GameObject::RemoveShields(void) {
+
+    for (int i = 0; i < shields_.size(); i++) {
+        delete shields_[i];
+    }
+    shields_.clear();
 }
 
 } // namespace game
@@ -2,108 +2,151 @@
 #define GAME_OBJECT_H_
 
 #include <glm/glm.hpp>
-#define GLEW_STATIC
-#include <GL/glew.h>
 #include <string>
 #include <vector>
 
-#include "shader.h"
-
+#include "atlas_region.h"
+#include "entity_store.h"
 
 namespace game {
 
+    // Kind of a game object, used to look up how two objects interact (see World)
+    enum ObjectType {
+        OBJECT_GENERIC,
+        OBJECT_PLAYER,
+        OBJECT_ENEMY,
+        OBJECT_SEEKER,
+        OBJECT_PENGUIN,
+        OBJECT_BUOY,
+        OBJECT_SHIELD,
+        OBJECT_SHIELD_POWER_UP,
+        OBJECT_STAR_POWER_UP,
+        OBJECT_ARROW_POWER_UP,
+        OBJECT_ARROW,
+        NUM_OBJECT_TYPES
+    };
+
     /*
-        GameObject is responsible for handling the rendering and updating of objects in the game world
-        The update method is virtual, so you can inherit from GameObject and override the update functionality (see PlayerGameObject for reference)
+        GameObject is a view over one entity of an EntityStore, which holds the hot state (position, velocity, angle, scale, mass, collidable)
+        The object itself only keeps the cold data (sprite, state, attachments), drawing it is left to the front-end (see Game)
+        The update method is virtual, so you can inherit from GameObject and override the behaviour (see PlayerGameObject for reference)
+        Behaviours only steer: the owner of the store moves every entity at once with EntityStore::Integrate
+        The object gives its slot back to the store when deleted, together with the attachments it owns
     */
     class GameObject {
 
         public:
             // Constructor
-            GameObject(const glm::vec3& position, GLuint texture);
-            GameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable);
-            GameObject(const glm::vec3 &position, GLuint texture, GLint num_elements, bool collidable, float mass);
-            GameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable, float mass, std::string state);
-            // Update the GameObject's state. Can be overriden for children
-            virtual void Update(double delta_time);
+            // The store must outlive the object
+            GameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite);
+            GameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable);
+            GameObject(EntityStore& store, const glm::vec3 &position, const AtlasRegion& sprite, int num_elements, bool collidable, float mass);
+            GameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable, float mass, std::string state);
+            virtual ~GameObject();
 
-            // Renders the GameObject using a shader
-            void Render(Shader &shader);
-            void Render(Shader& shader, glm::mat4 ParentTransformation);
+            // Update the GameObject's behaviour (velocity, angle, state). Can be overriden for children
+            // current_time is the simulation time in seconds, never read the wall clock from here
+            virtual void Update(double delta_time, double current_time);
 
             // Getters
-            inline glm::vec3& GetPosition(void) { return position_; }
-            inline float GetScale(void) { return scale_; }
-            inline float GetMass(void) { return mass_; }
-            inline glm::vec3& GetVelocity(void) { return velocity_; }
-            inline bool GetCollidable(void) { return collidable_; }
+            inline glm::vec3& GetPosition(void) { return store_->GetPosition(index_); }
+            inline float GetScale(void) { return store_->GetScale(index_); }
+            inline float GetMass(void) { return store_->GetMass(index_); }
+            inline glm::vec3& GetVelocity(void) { return store_->GetVelocity(index_); }
+            inline bool GetCollidable(void) { return store_->GetCollidable(index_) != 0; }
             inline std::string GetState(void) { return state_; }
-            inline float GetAngle(void) { return angle_; }
+            inline float GetAngle(void) { return store_->GetAngle(index_); }
+            inline glm::vec3 GetInterpolatedPosition(float alpha) const { return store_->GetInterpolatedPosition(index_, alpha); }
+            inline float GetInterpolatedAngle(float alpha) const { return store_->GetInterpolatedAngle(index_, alpha); }
+            inline int GetEntity(void) const { return index_; }
+            inline ObjectType GetType(void) const { return type_; }
+            inline EntityHandle GetHandle(void) const { return store_->GetHandle(index_); }
+            inline bool IsPendingDestroy(void) const { return pending_destroy_; }
             inline glm::mat4& GetTransformationMatrix(void) { return transformation_matrix_; }
             inline glm::mat4& GetRotationMatrix(void) { return rotation_matrix_; }
             inline glm::mat4& GetTranslationMatrix(void) { return translation_matrix_; }
             inline glm::mat4& GetMovementMatrix(void) { return movement_matrix_; }
+            inline int GetNumElements(void) { return num_elements_; }
+            inline const AtlasRegion& GetSprite(void) { return sprite_; }
             inline std::vector<GameObject*> GetChildren(void) { return children_; }
-            inline std::vector<GameObject*> GetBullet(void) { return bullet_; }
-            inline std::vector<GameObject*> GetArrow(void) { return arrow_; }
             inline std::vector<GameObject*> GetShields(void) { return shields_; }
 
             // Setters
-            inline void SetPosition(const glm::vec3& position) { position_ = position; }
-            inline void SetScale(float scale) { scale_ = scale; }
+            inline void SetPosition(const glm::vec3& position) { store_->GetPosition(index_) = position; }
+            inline void SetScale(float scale) { store_->GetScale(index_) = scale; }
             inline void SetState(std::string state) { state_ = state; }
+            inline void SetSprite(const AtlasRegion& sprite) { sprite_ = sprite; }
+            inline void SetPendingDestroy(void) { pending_destroy_ = true; }
 
             inline void SetVelocity(const glm::vec3& velocity) { 
                 if (velocity.x > 2 || velocity.y > 2 || velocity.x < -2 || velocity.y < -2) {
                 }
                 else {
-                    velocity_ = velocity; 
+                    store_->GetVelocity(index_) = velocity;
                 }
             }
 
-            inline void SetVelocity(const glm::vec3& velocity, bool override) { velocity_ = velocity; }
-            inline void SetCollidable(bool collidable) { collidable_ = collidable; }
-            inline void SetAngle(float angle) { angle_ = angle; }
-            inline void SetMass(float mass) { mass_ = mass; }
+            inline void SetVelocity(const glm::vec3& velocity, bool override) { store_->GetVelocity(index_) = velocity; }
+            inline void SetCollidable(bool collidable) { store_->GetCollidable(index_) = collidable; }
+            inline void SetAngle(float angle) { store_->GetAngle(index_) = angle; }
+            inline void SetMass(float mass) { store_->GetMass(index_) = mass; }
             inline void SetTransformationMatrix(const glm::mat4& matrix) { transformation_matrix_ = matrix; }
             inline void SetRotationMatrix(const glm::mat4& matrix) { rotation_matrix_ = matrix; }
+            inline void SetTranslationMatrix(const glm::mat4& matrix) { translation_matrix_ = matrix; }
             inline void SetMovementMatrix(const glm::mat4& matrix) { movement_matrix_ = matrix; }
             inline void SetChildren(std::vector<GameObject*> children) { children_ = children; }
             inline void AddChild(GameObject* child) { children_.push_back(child); }
-            inline void AddBullet(GameObject* bullet) { bullet_.push_back(bullet); }
-            inline void AddArrow(GameObject* arrow) { arrow_.push_back(arrow); }
             inline void AddShield(GameObject* shield) { shields_.push_back(shield); }
 
-            inline void DeleteBullet() { bullet_.clear(); }
-            inline void DeleteArrow() { arrow_.clear(); }
-            inline void RemoveShields() { shields_.clear(); }
+            // Delete the attachments, freeing their entities
+            void RemoveShields(void);
+
+            // Park the object at step (the first step it misses, at time): it keeps its place but stops moving
+            void Sleep(unsigned long long step, double time);
+
+            // Bring a parked object up to date before step, as if it had been updated every step it missed
+            void Wake(unsigned long long step, double timestep);
+
+            inline bool IsDormant(void) const { return dormant_; }
 
 
         protected:
-            // Object's Transform Variables
-            // TODO: Add more transformation variables
-            glm::vec3 position_;
-            float scale_;
-            float angle_;
-            float mass_;
-            glm::vec3 velocity_;
+            // Entity holding the object's transform and physics state
+            EntityStore *store_;
+            int index_;
+
+            // Set by each subclass
+            ObjectType type_;
+
+            // Queued for destruction at the end of the step, the object takes no further part in it
+            bool pending_destroy_;
+
+            // Parked by Sleep(): first step missed, its time and the velocity to resume with
+            bool dormant_;
+            unsigned long long dormant_step_;
+            double dormant_time_;
+            glm::vec3 dormant_velocity_;
+
+            // Move the object as num_steps updates of timestep seconds from start_time would have, velocity included
+            // Objects keep their velocity by default, behaviours with a closed form override this
+            virtual void FastForward(double start_time, int num_steps, double timestep);
+
+            // Displacement of a patrol, velocity (cos t, sin t) at the times start_time + k * timestep (0 <= k < num_steps)
+            static glm::vec3 PatrolDisplacement(double start_time, int num_steps, double timestep);
+
+            // Cached matrices
             glm::mat4 transformation_matrix_;
             glm::mat4 rotation_matrix_;
             glm::mat4 translation_matrix_;
             glm::mat4 movement_matrix_;
             std::vector<GameObject*> children_;
-            std::vector<GameObject*> bullet_;
-            std::vector<GameObject*> arrow_;
             std::vector<GameObject*> shields_;
 
             // Object's details
-            GLint num_elements_;
-
-            // Object's texture reference
-            GLuint texture_;
+            int num_elements_;
 
-            //Collidable bool
-            bool collidable_;
+            // Where the object's image lives in the sprite atlas
+            AtlasRegion sprite_;
 
             std::string state_;
 
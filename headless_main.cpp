@@ -0,0 +1,180 @@
+/*
+ *
+ * Runs the game simulation without a window, OpenGL context or audio device
+ *
+ * Usage: yume_headless [--ticks N] [--enemies N] [--seed N] [--timestep seconds] [--threads N] [--invulnerable]
+ *                      [--activity-radius units] [--level file] [--record file] [--replay file] [--profile file]
+ *
+ * --threads 0 uses every hardware thread, the results are the same whatever the number
+ * --activity-radius puts the objects farther than that from the player to sleep, so that a step only costs what is near
+ * --level creates the scene from a level file (see level_converter) instead of the built-in one
+ * --record writes the input of every tick to an input log, --replay runs a log again (from this program or the game)
+ *   with the setup and timestep it was recorded with, as fast as possible; it must be given the --level it was recorded on
+ * --profile writes a Chrome trace of the run, in builds configured with YUME_PROFILE
+ *
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+
+#include "clock.h"
+#include "input_log.h"
+#include "profiler.h"
+#include "world.h"
+
+// Macro for printing exceptions
+#define PrintException(exception_object)\
+    std::cerr << exception_object.what() << std::endl
+
+int main(int argc, char **argv){
+    long long ticks = 10000;
+    int enemies = 0;
+    unsigned int seed = 1;
+    double timestep = 1.0 / 60.0;
+    int threads = 1;
+    bool invulnerable = false;
+    float activity_radius = 0.0f;
+    const char *profile_filename = NULL;
+    const char *record_filename = NULL;
+    const char *replay_filename = NULL;
+    const char *level_filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = atoll(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--enemies") == 0 && i + 1 < argc) {
+            enemies = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--timestep") == 0 && i + 1 < argc) {
+            timestep = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--invulnerable") == 0) {
+            invulnerable = true;
+        }
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profile_filename = argv[++i];
+        }
+        else if (strcmp(argv[i], "--activity-radius") == 0 && i + 1 < argc) {
+            activity_radius = (float) atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            level_filename = argv[++i];
+        }
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_filename = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_filename = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--ticks N] [--enemies N] [--seed N] [--timestep seconds] [--threads N] [--invulnerable]"
+                      << " [--activity-radius units] [--level file] [--record file] [--replay file] [--profile file]" << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        // A replay brings its own setup and length
+        game::InputLog log;
+        if (replay_filename) {
+            log.Load(replay_filename);
+            timestep = log.GetTimestep();
+            enemies = log.GetNumEnemies();
+            seed = log.GetSeed();
+            invulnerable = log.IsInvulnerable();
+            activity_radius = log.GetActivityRadius();
+            ticks = log.GetNumTicks();
+        }
+        else {
+            log.SetSetup(timestep, enemies, seed, invulnerable, activity_radius);
+        }
+
+        game::ManualClock clock;
+        game::World world(clock, timestep, 8, threads);
+
+        // The level only needs to stay mapped while the world is set up
+        game::Level level;
+        std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+        if (level_filename) {
+            level.Load(level_filename);
+        }
+
+        // No atlas is needed without a renderer
+        game::AtlasRegion sprites[game::NUM_SPRITES];
+        world.Setup(sprites, 6, level_filename ? &level : NULL);
+        unsigned long long level_hash = level_filename ? level.GetHash() : 0;
+        if (replay_filename && log.GetLevelHash() != level_hash) {
+            throw(std::runtime_error(std::string("Input log ") + replay_filename + " was recorded on another level, give the --level it was recorded with"));
+        }
+        log.SetLevelHash(level_hash);
+        std::chrono::duration<double> load_elapsed = std::chrono::steady_clock::now() - load_start;
+        world.SetPlayerInvulnerable(invulnerable);
+        world.SetActivityRadius(activity_radius);
+        world.SpawnEnemies(enemies, 4.0f + 2.0f * sqrt((float) enemies), seed);
+        if (replay_filename) {
+            world.ReplayInput(&log);
+        }
+        else if (record_filename) {
+            world.RecordInput(&log);
+        }
+
+        // Step as fast as possible, the clock only moves when we say so
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        // Count steps rather than clock advances, so rounding in the clock cannot cut the run short
+        while ((long long) world.GetNumSteps() < ticks && !world.IsOver()) {
+            clock.Advance(timestep);
+            world.Advance();
+            world.ClearEvents();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "objects: " << world.GetGameObjects().size() << std::endl;
+        std::cout << "setup time: " << load_elapsed.count() << " s" << std::endl;
+        std::cout << "active objects: " << world.GetNumActive() << std::endl;
+        std::cout << "threads: " << world.GetNumThreads() << std::endl;
+        std::cout << "ticks: " << world.GetNumSteps() << std::endl;
+        std::cout << "simulated time: " << world.GetTime() << " s" << std::endl;
+        std::cout << "wall time: " << elapsed.count() << " s" << std::endl;
+        std::cout << "ticks per second: " << world.GetNumSteps() / elapsed.count() << std::endl;
+
+        // Where the player ended up, equal between replays of the same log
+        glm::vec3 player = world.GetPlayer()->GetPosition();
+        std::cout << "player: " << player.x << " " << player.y << std::endl;
+        if (world.IsOver()) {
+            std::cout << "game over" << std::endl;
+        }
+
+        if (record_filename) {
+            log.Save(record_filename);
+            std::cout << "input log: " << record_filename << " (" << log.GetNumChanges() << " changes)" << std::endl;
+        }
+
+        if (profile_filename) {
+#ifdef YUME_PROFILE
+            game::Profiler::Dump(profile_filename);
+            std::cout << "profile: " << profile_filename << std::endl;
+#else
+            std::cerr << "Profiling is disabled in this build, configure with -DYUME_PROFILE=ON" << std::endl;
+#endif
+        }
+    }
+    catch (std::exception &e){
+        // Catch and print any errors
+        PrintException(e);
+        return 1;
+    }
+
+    return 0;
+}
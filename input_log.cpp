@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <ios>
+
+#include "input_log.h"
+
+namespace game {
+
+InputLog::InputLog(void)
+{
+    timestep_ = 1.0 / 60.0;
+    num_enemies_ = 0;
+    seed_ = 1;
+    invulnerable_ = false;
+    activity_radius_ = 0.0f;
+    level_hash_ = 0;
+    num_ticks_ = 0;
+}
+
+
+unsigned char InputLog::Pack(const PlayerInput& input)
+{
+    return (input.forward ? 1 : 0) | (input.backward ? 2 : 0) | (input.turn_left ? 4 : 0) |
+           (input.turn_right ? 8 : 0) | (input.fire_bullet ? 16 : 0) | (input.fire_arrow ? 32 : 0);
+}
+
+
+PlayerInput InputLog::Unpack(unsigned char buttons)
+{
+    PlayerInput input;
+    input.forward = (buttons & 1) != 0;
+    input.backward = (buttons & 2) != 0;
+    input.turn_left = (buttons & 4) != 0;
+    input.turn_right = (buttons & 8) != 0;
+    input.fire_bullet = (buttons & 16) != 0;
+    input.fire_arrow = (buttons & 32) != 0;
+    return input;
+}
+
+
+void InputLog::Record(unsigned int tick, const PlayerInput& input)
+{
+    // Nothing pressed before the first record
+    unsigned char buttons = Pack(input);
+    unsigned char last = changes_.empty() ? 0 : changes_.back().buttons;
+    if (buttons != last) {
+        Change change;
+        change.tick = tick;
+        change.buttons = buttons;
+        changes_.push_back(change);
+    }
+    num_ticks_ = std::max(num_ticks_, tick + 1);
+}
+
+
+PlayerInput InputLog::Get(unsigned int tick) const
+{
+    // Last change at or before the tick
+    std::vector<Change>::const_iterator it = std::upper_bound(changes_.begin(), changes_.end(), tick,
+        [](unsigned int t, const Change& change) { return t < change.tick; });
+    if (it == changes_.begin()) {
+        return PlayerInput();
+    }
+    return Unpack((it - 1)->buttons);
+}
+
+
+void InputLog::Save(const std::string& filename) const
+{
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    if (out.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    InputLogFileHeader header;
+    memcpy(header.magic, INPUT_LOG_MAGIC, 4);
+    header.version = INPUT_LOG_VERSION;
+    header.timestep = timestep_;
+    header.num_enemies = num_enemies_;
+    header.seed = seed_;
+    header.invulnerable = invulnerable_ ? 1 : 0;
+    header.activity_radius = activity_radius_;
+    header.num_ticks = num_ticks_;
+    header.num_changes = changes_.size();
+    header.level_hash = level_hash_;
+    out.write((const char *) &header, sizeof(header));
+
+    for (int i = 0; i < changes_.size(); i++) {
+        out.write((const char *) &changes_[i].tick, sizeof(changes_[i].tick));
+        out.write((const char *) &changes_[i].buttons, sizeof(changes_[i].buttons));
+    }
+
+    if (out.fail()) {
+        throw(std::ios_base::failure(std::string("Error writing file ") + filename));
+    }
+}
+
+
+void InputLog::Load(const std::string& filename)
+{
+    std::ifstream f(filename.c_str(), std::ios::binary);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    InputLogFileHeader header;
+    f.read((char *) &header, sizeof(header));
+    if (!f || strncmp(header.magic, INPUT_LOG_MAGIC, 4) != 0 || header.version != INPUT_LOG_VERSION) {
+        throw(std::ios_base::failure(std::string("Not an input log: ") + filename));
+    }
+    timestep_ = header.timestep;
+    num_enemies_ = header.num_enemies;
+    seed_ = header.seed;
+    invulnerable_ = header.invulnerable != 0;
+    activity_radius_ = header.activity_radius;
+    level_hash_ = header.level_hash;
+    num_ticks_ = header.num_ticks;
+
+    // The records must all be there before any memory is set aside for them
+    std::streamoff start = f.tellg();
+    f.seekg(0, std::ios::end);
+    std::streamoff size = f.tellg() - start;
+    f.seekg(start);
+    if (!f || size / INPUT_LOG_CHANGE_SIZE < header.num_changes) {
+        throw(std::ios_base::failure(std::string("Truncated input log: ") + filename));
+    }
+
+    changes_.resize(header.num_changes);
+    for (int i = 0; i < changes_.size(); i++) {
+        f.read((char *) &changes_[i].tick, sizeof(changes_[i].tick));
+        f.read((char *) &changes_[i].buttons, sizeof(changes_[i].buttons));
+
+        // Get() looks ticks up by binary search
+        if (i > 0 && changes_[i].tick <= changes_[i - 1].tick) {
+            changes_.clear();
+            throw(std::ios_base::failure(std::string("Corrupt input log: ") + filename));
+        }
+    }
+    if (!f) {
+        changes_.clear();
+        throw(std::ios_base::failure(std::string("Truncated input log: ") + filename));
+    }
+}
+
+} // namespace game
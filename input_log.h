@@ -0,0 +1,94 @@
+#ifndef INPUT_LOG_H_
+#define INPUT_LOG_H_
+
+#include <string>
+#include <vector>
+
+#include "world.h"
+
+namespace game {
+
+    // Binary input log: header, then one change per record
+#define INPUT_LOG_MAGIC "YINP"
+#define INPUT_LOG_VERSION 3
+
+    struct InputLogFileHeader {
+        char magic[4];
+        unsigned int version;
+        double timestep;           // Seconds per simulation tick
+        unsigned int num_enemies;  // Extra enemies spawned at setup (World::SpawnEnemies) and their seed
+        unsigned int seed;
+        unsigned int invulnerable;
+        float activity_radius;     // World::SetActivityRadius()
+        unsigned int num_ticks;    // Ticks the recorded run lasted
+        unsigned int num_changes;  // Records following the header: tick (4 bytes) and buttons (1 byte)
+        unsigned long long level_hash;  // Level::GetHash() of the level the run started from, 0 for the built-in scene
+    };
+
+    // Size of one record in the file
+#define INPUT_LOG_CHANGE_SIZE 5
+
+    /*
+        InputLog holds the player input of every simulation tick of a run, with what is needed to set the run up again
+        Only the ticks where the input changed are kept, a few bytes per key press
+        Record a run by attaching the log to the World, which logs the input of each tick as it steps;
+        replay it by attaching the loaded log instead, the World then takes its input from the log
+        With the same setup and timestep every tick sees the same input, so two replays do the same work
+    */
+    class InputLog {
+
+        public:
+            InputLog(void);
+
+            // Input of tick (counted from 0), which must come after the ticks already recorded
+            void Record(unsigned int tick, const PlayerInput& input);
+
+            // Input of tick, what was last recorded up to it
+            PlayerInput Get(unsigned int tick) const;
+
+            // Write and read the log, throw std::ios_base::failure on errors
+            void Save(const std::string& filename) const;
+            void Load(const std::string& filename);
+
+            // Setup of the recorded run
+            inline void SetSetup(double timestep, int num_enemies, unsigned int seed, bool invulnerable, float activity_radius) {
+                timestep_ = timestep; num_enemies_ = num_enemies; seed_ = seed; invulnerable_ = invulnerable; activity_radius_ = activity_radius;
+            }
+            inline double GetTimestep(void) const { return timestep_; }
+            inline int GetNumEnemies(void) const { return num_enemies_; }
+            inline unsigned int GetSeed(void) const { return seed_; }
+            inline bool IsInvulnerable(void) const { return invulnerable_; }
+            inline float GetActivityRadius(void) const { return activity_radius_; }
+
+            // Level of the recorded run, a replay must start from the same one
+            inline void SetLevelHash(unsigned long long hash) { level_hash_ = hash; }
+            inline unsigned long long GetLevelHash(void) const { return level_hash_; }
+
+            // Ticks recorded
+            inline unsigned int GetNumTicks(void) const { return num_ticks_; }
+            inline int GetNumChanges(void) const { return changes_.size(); }
+
+        private:
+            // Input from tick on, the buttons packed one per bit
+            struct Change {
+                unsigned int tick;
+                unsigned char buttons;
+            };
+
+            double timestep_;
+            int num_enemies_;
+            unsigned int seed_;
+            bool invulnerable_;
+            float activity_radius_;
+            unsigned long long level_hash_;
+            unsigned int num_ticks_;
+            std::vector<Change> changes_;
+
+            static unsigned char Pack(const PlayerInput& input);
+            static PlayerInput Unpack(unsigned char buttons);
+
+    }; // class InputLog
+
+} // namespace game
+
+#endif // INPUT_LOG_H_
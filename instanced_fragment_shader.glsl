@@ -0,0 +1,28 @@
+// Source code of fragment shader for instanced sprites
+#version 330
+
+// Attributes passed from the vertex shader
+in vec4 color_interp;
+in vec2 uv_interp;
+flat in float layer_interp;
+
+// Sprite atlas, one sprite per layer
+uniform sampler2DArray onetex;
+
+// Output color
+out vec4 frag_color;
+
+void main()
+{
+    // Sample the sprite's layer and apply its tint
+    vec4 color = texture(onetex, vec3(uv_interp, layer_interp));
+
+    // Assign color to fragment
+    frag_color = vec4(color.rgb * color_interp.rgb, color.a);
+
+    // Check for transparency
+    if(color.a < 1.0)
+    {
+         discard;
+    }
+}
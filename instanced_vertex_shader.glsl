@@ -0,0 +1,35 @@
+// Source code of vertex shader for instanced sprites
+#version 330
+
+// Vertex buffer
+in vec2 vertex;
+in vec2 uv;
+
+// Instance buffer
+in mat4 instance_transformation;
+in vec4 instance_tint;
+in vec2 instance_params; // texture layer, depth
+
+// Per-frame data shared by every program (see frame_uniforms.h)
+layout(std140) uniform FrameUniforms {
+    mat4 view_matrix;
+    float time;
+};
+
+// Attributes forwarded to the fragment shader
+out vec4 color_interp;
+out vec2 uv_interp;
+flat out float layer_interp;
+
+void main()
+{
+    // Transform vertex, pushing it back by the sprite's depth
+    vec4 vertex_pos = instance_transformation * vec4(vertex, 0.0, 1.0);
+    vertex_pos.z += instance_params.y;
+    gl_Position = view_matrix * vertex_pos;
+
+    // Pass attributes to fragment shader
+    color_interp = instance_tint;
+    uv_interp = uv;
+    layer_interp = instance_params.x;
+}
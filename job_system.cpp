@@ -0,0 +1,142 @@
+#include <algorithm>
+
+#include "job_system.h"
+#include "profiler.h"
+
+namespace game {
+
+JobSystem::JobSystem(int num_threads)
+    : generation_(0), quit_(false), remaining_(0)
+{
+    if (num_threads <= 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        queues_.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+
+    // Worker 0 is the thread calling ParallelFor
+    for (int i = 1; i < num_threads; i++) {
+        threads_.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+    }
+}
+
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wake_.notify_all();
+    for (int i = 0; i < threads_.size(); i++) {
+        threads_[i].join();
+    }
+}
+
+
+void JobSystem::ParallelFor(int begin, int end, int grain, const RangeJob& job)
+{
+    if (end <= begin) {
+        return;
+    }
+    grain = std::max(1, grain);
+    int num_chunks = (end - begin + grain - 1) / grain;
+
+    // Not worth waking anybody
+    if (num_chunks == 1 || queues_.size() == 1) {
+        job(begin, end, 0);
+        return;
+    }
+
+    // Contiguous shares keep each worker on neighbouring data until it has to steal
+    remaining_ = num_chunks;
+    int num_workers = queues_.size();
+    for (int w = 0; w < num_workers; w++) {
+        int first = num_chunks * w / num_workers;
+        int last = num_chunks * (w + 1) / num_workers;
+        std::lock_guard<std::mutex> lock(queues_[w]->mutex);
+        for (int c = first; c < last; c++) {
+            Chunk chunk;
+            chunk.begin = begin + c * grain;
+            chunk.end = std::min(end, chunk.begin + grain);
+            chunk.job = &job;
+            queues_[w]->chunks.push_back(chunk);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation_++;
+    }
+    wake_.notify_all();
+
+    // Help, then wait for the chunks other workers are still running
+    while (RunOne(0)) {
+    }
+    while (remaining_.load() > 0) {
+        std::this_thread::yield();
+    }
+}
+
+
+void JobSystem::WorkerLoop(int worker)
+{
+    unsigned long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return quit_ || generation_ != seen; });
+            if (quit_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        while (RunOne(worker)) {
+        }
+    }
+}
+
+
+bool JobSystem::RunOne(int worker)
+{
+    Chunk chunk;
+    bool found = false;
+
+    // Own queue first, newest chunk
+    {
+        Queue& own = *queues_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.chunks.empty()) {
+            chunk = own.chunks.back();
+            own.chunks.pop_back();
+            found = true;
+        }
+    }
+
+    // Then steal the oldest chunk of the next worker that has one
+    for (int k = 1; !found && k < queues_.size(); k++) {
+        Queue& victim = *queues_[(worker + k) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.chunks.empty()) {
+            chunk = victim.chunks.front();
+            victim.chunks.pop_front();
+            found = true;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    {
+        YUME_PROFILE_ZONE("Job");
+        (*chunk.job)(chunk.begin, chunk.end, worker);
+    }
+    remaining_--;
+    return true;
+}
+
+} // namespace game
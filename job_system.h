@@ -0,0 +1,72 @@
+#ifndef JOB_SYSTEM_H_
+#define JOB_SYSTEM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+    /*
+        JobSystem is a work-stealing thread pool for data-parallel loops
+        ParallelFor cuts a range into chunks and hands each worker a contiguous share of them in its own queue
+        A worker takes chunks from the back of its queue and, once it runs dry, steals from the front of the others
+        The calling thread is worker 0 and works too, so a pool of one thread runs everything inline
+    */
+    class JobSystem {
+
+        public:
+            // Body of a loop over [begin, end), worker identifies the thread running it, in [0, GetNumThreads())
+            // Chunks run by the same worker never overlap in time, so per-worker scratch data needs no locking
+            typedef std::function<void(int begin, int end, int worker)> RangeJob;
+
+            // num_threads counts the calling thread, 0 uses one thread per hardware thread
+            JobSystem(int num_threads = 0);
+            ~JobSystem();
+
+            // Run job over [begin, end) in chunks of at most grain items and return once every chunk is done
+            // Not reentrant: job must not call ParallelFor
+            void ParallelFor(int begin, int end, int grain, const RangeJob& job);
+
+            inline int GetNumThreads(void) const { return queues_.size(); }
+
+        private:
+            struct Chunk {
+                int begin;
+                int end;
+                const RangeJob* job;
+            };
+
+            // Chunks waiting in one worker's queue
+            struct Queue {
+                std::mutex mutex;
+                std::deque<Chunk> chunks;
+            };
+
+            std::vector<std::unique_ptr<Queue>> queues_;
+            std::vector<std::thread> threads_;
+
+            // Workers sleep on wake_ until the generation changes
+            std::mutex mutex_;
+            std::condition_variable wake_;
+            unsigned long generation_;
+            bool quit_;
+
+            // Chunks of the current loop not finished yet
+            std::atomic<int> remaining_;
+
+            void WorkerLoop(int worker);
+
+            // Run one chunk from the worker's own queue or stolen from another, false if there was none
+            bool RunOne(int worker);
+
+    }; // class JobSystem
+
+} // namespace game
+
+#endif // JOB_SYSTEM_H_
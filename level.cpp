@@ -0,0 +1,122 @@
+#include <cstring>
+#include <ios>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "level.h"
+
+namespace game {
+
+const char *level_state_names_g[NUM_LEVEL_STATES] = { "", "patrolling", "moving" };
+
+
+Level::Level(void)
+{
+    data_ = NULL;
+    size_ = 0;
+    entities_ = NULL;
+    num_entities_ = 0;
+}
+
+
+Level::~Level()
+{
+    Unmap();
+}
+
+
+void Level::Load(const std::string& filename)
+{
+    Unmap();
+
+    // The mapping outlives the file handles, they are closed right away
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file, &file_size);
+    size_ = (size_t) file_size.QuadPart;
+    if (size_ > 0) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping) {
+            data_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+    struct stat file_stat;
+    fstat(file, &file_stat);
+    size_ = (size_t) file_stat.st_size;
+    if (size_ > 0) {
+        data_ = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data_ == MAP_FAILED) {
+            data_ = NULL;
+        }
+    }
+    close(file);
+#endif
+    if (!data_) {
+        size_ = 0;
+        throw(std::ios_base::failure(std::string("Error mapping file ") + filename));
+    }
+
+    const LevelFileHeader *header = (const LevelFileHeader *) data_;
+    if (size_ < sizeof(LevelFileHeader) || strncmp(header->magic, LEVEL_MAGIC, 4) != 0 ||
+        header->version != LEVEL_VERSION || header->entity_size != sizeof(LevelEntity)) {
+        Unmap();
+        throw(std::ios_base::failure(std::string("Not a level: ") + filename));
+    }
+    if ((size_ - sizeof(LevelFileHeader)) / sizeof(LevelEntity) < header->num_entities) {
+        Unmap();
+        throw(std::ios_base::failure(std::string("Truncated level: ") + filename));
+    }
+    entities_ = (const LevelEntity *) (header + 1);
+    num_entities_ = header->num_entities;
+}
+
+
+unsigned long long Level::GetHash(void) const
+{
+    const unsigned char *bytes = (const unsigned char *) entities_;
+    size_t length = num_entities_ * sizeof(LevelEntity);
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+
+void Level::Unmap(void)
+{
+    if (data_) {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        munmap(data_, size_);
+#endif
+    }
+    data_ = NULL;
+    size_ = 0;
+    entities_ = NULL;
+    num_entities_ = 0;
+}
+
+} // namespace game
@@ -0,0 +1,80 @@
+#ifndef LEVEL_H_
+#define LEVEL_H_
+
+#include <cstddef>
+#include <string>
+
+namespace game {
+
+    // Layout of a level file, written by level_converter and read by Level:
+    // the header, then num_entities LevelEntity records
+#define LEVEL_MAGIC "YLVL"
+#define LEVEL_VERSION 1
+
+    struct LevelFileHeader {
+        char magic[4];
+        unsigned int version;
+        unsigned int entity_size;  // sizeof(LevelEntity), guards against a mismatched layout
+        unsigned int num_entities;
+    };
+
+    // State an entity starts in, stored as an index so that records keep a fixed size
+    enum LevelState {
+        LEVEL_STATE_NONE,
+        LEVEL_STATE_PATROLLING,
+        LEVEL_STATE_MOVING,
+        NUM_LEVEL_STATES
+    };
+
+    // Name of each LevelState, as used by the game objects and in level text files
+    extern const char *level_state_names_g[NUM_LEVEL_STATES];
+
+    // Bit of LevelEntity::flags
+#define LEVEL_ENTITY_COLLIDABLE 1
+
+    // One entity of a level, the sprite follows from the type
+    struct LevelEntity {
+        unsigned int type;   // ObjectType
+        float x, y;
+        float scale;
+        float mass;
+        unsigned int flags;
+        unsigned int state;  // LevelState
+    };
+
+    /*
+        Level maps a level file into memory and exposes its entity table in place, nothing is parsed or copied
+        The World builds its objects straight from the table, so loading costs about as much as creating the objects
+        The table stays valid until the level is loaded again or destroyed
+    */
+    class Level {
+
+        public:
+            Level(void);
+            ~Level();
+
+            // Map a level file, throws std::ios_base::failure if it cannot be read or is not a level
+            void Load(const std::string& filename);
+
+            // Getters
+            inline const LevelEntity* GetEntities(void) const { return entities_; }
+            inline int GetNumEntities(void) const { return num_entities_; }
+
+            // 64-bit FNV-1a of the entity table, tells apart the scenes two runs started from
+            unsigned long long GetHash(void) const;
+
+        private:
+            // Mapped file
+            void *data_;
+            size_t size_;
+
+            const LevelEntity *entities_;
+            int num_entities_;
+
+            void Unmap(void);
+
+    }; // class Level
+
+} // namespace game
+
+#endif // LEVEL_H_
@@ -0,0 +1,161 @@
+/*
+ *
+ * Asset build step: converts a level written as text into the binary level file that Level maps
+ *
+ * Usage: level_converter <level text file> <output file>
+ *
+ * One entity per line: type x y [scale [mass [collidable [state]]]]
+ * type is one of player, enemy, seeker, penguin, buoy, shield_power_up, star_power_up, arrow_power_up
+ * collidable is 0 or 1, state is none, patrolling or moving; fields left out take the type's defaults
+ * Empty lines and everything after a # are ignored
+ *
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "game_object.h"
+#include "level.h"
+
+// Name of a placeable type and what its fields default to
+struct TypeInfo {
+    const char *name;
+    game::ObjectType type;
+    float mass;
+    bool collidable;
+    game::LevelState state;
+};
+
+static const TypeInfo types_g[] = {
+    { "player", game::OBJECT_PLAYER, 10.0f, true, game::LEVEL_STATE_NONE },
+    { "enemy", game::OBJECT_ENEMY, 10.0f, true, game::LEVEL_STATE_PATROLLING },
+    { "seeker", game::OBJECT_SEEKER, 5.0f, true, game::LEVEL_STATE_MOVING },
+    { "penguin", game::OBJECT_PENGUIN, 5.0f, false, game::LEVEL_STATE_PATROLLING },
+    { "buoy", game::OBJECT_BUOY, 10.0f, true, game::LEVEL_STATE_NONE },
+    { "shield_power_up", game::OBJECT_SHIELD_POWER_UP, 0.0f, false, game::LEVEL_STATE_NONE },
+    { "star_power_up", game::OBJECT_STAR_POWER_UP, 0.0f, false, game::LEVEL_STATE_NONE },
+    { "arrow_power_up", game::OBJECT_ARROW_POWER_UP, 0.0f, false, game::LEVEL_STATE_NONE },
+};
+
+
+static const TypeInfo* FindType(const std::string& name)
+{
+    for (int i = 0; i < sizeof(types_g) / sizeof(types_g[0]); i++) {
+        if (name == types_g[i].name) {
+            return &types_g[i];
+        }
+    }
+    return NULL;
+}
+
+
+static int FindState(const std::string& name)
+{
+    if (name == "none") {
+        return game::LEVEL_STATE_NONE;
+    }
+    for (int i = 1; i < game::NUM_LEVEL_STATES; i++) {
+        if (name == game::level_state_names_g[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        std::cerr << "Usage: level_converter <level text file> <output file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream in(argv[1]);
+    if (in.fail()) {
+        std::cerr << "Error opening file " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::vector<game::LevelEntity> entities;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+
+        std::istringstream fields(line);
+        std::string type_name;
+        if (!(fields >> type_name)) {
+            continue;
+        }
+
+        const TypeInfo *info = FindType(type_name);
+        if (!info) {
+            std::cerr << argv[1] << ":" << line_number << ": unknown type " << type_name << std::endl;
+            return 1;
+        }
+
+        game::LevelEntity entity;
+        entity.type = info->type;
+        entity.scale = 1.0f;
+        entity.mass = info->mass;
+        entity.flags = info->collidable ? LEVEL_ENTITY_COLLIDABLE : 0;
+        entity.state = info->state;
+        if (!(fields >> entity.x >> entity.y)) {
+            std::cerr << argv[1] << ":" << line_number << ": expected a position" << std::endl;
+            return 1;
+        }
+
+        // Optional fields, in order
+        std::string field;
+        if (fields >> field) {
+            entity.scale = (float) atof(field.c_str());
+        }
+        if (fields >> field) {
+            entity.mass = (float) atof(field.c_str());
+        }
+        if (fields >> field) {
+            entity.flags = atoi(field.c_str()) ? LEVEL_ENTITY_COLLIDABLE : 0;
+        }
+        if (fields >> field) {
+            int state = FindState(field);
+            if (state < 0) {
+                std::cerr << argv[1] << ":" << line_number << ": unknown state " << field << std::endl;
+                return 1;
+            }
+            entity.state = state;
+        }
+        entities.push_back(entity);
+    }
+
+    std::ofstream out(argv[2], std::ios::binary);
+    if (out.fail()) {
+        std::cerr << "Error opening file " << argv[2] << std::endl;
+        return 1;
+    }
+
+    game::LevelFileHeader header;
+    memcpy(header.magic, LEVEL_MAGIC, 4);
+    header.version = LEVEL_VERSION;
+    header.entity_size = sizeof(game::LevelEntity);
+    header.num_entities = entities.size();
+    out.write((const char *) &header, sizeof(header));
+    if (!entities.empty()) {
+        out.write((const char *) &entities[0], entities.size() * sizeof(game::LevelEntity));
+    }
+    if (out.fail()) {
+        std::cerr << "Error writing file " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Converted " << entities.size() << " entities into " << argv[2] << std::endl;
+    return 0;
+}
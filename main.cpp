@@ -6,6 +6,7 @@
  *
  */
 
+#include <cstring>
 #include <iostream>
 #include <exception>
 #include "game.h"
@@ -15,12 +16,42 @@
     std::cerr << exception_object.what() << std::endl
 
 // Main function that builds and runs the game
-int main(void){
+// Usage: Yume [--level file] [--record file | --replay file]
+int main(int argc, char **argv){
     game::Game the_game;
+    const char *record_filename = NULL;
+    const char *replay_filename = NULL;
+    const char *level_filename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_filename = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_filename = argv[++i];
+        }
+        else if (strcmp(argv[i], "--level") == 0 && i + 1 < argc) {
+            level_filename = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--level file] [--record file | --replay file]" << std::endl;
+            return 1;
+        }
+    }
 
     try {
         // Initialize graphics libraries and main window
         the_game.Init();
+        // Record the input, or play a recording back
+        if (replay_filename) {
+            the_game.ReplayInput(replay_filename);
+        }
+        else if (record_filename) {
+            the_game.RecordInput(record_filename);
+        }
+        if (level_filename) {
+            the_game.SetLevel(level_filename);
+        }
         // Setup the game (scene, game objects, etc.)
         the_game.Setup();
         // Run the game
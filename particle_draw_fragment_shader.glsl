@@ -0,0 +1,21 @@
+// Source code of fragment shader drawing the particles
+#version 330
+
+// Attributes passed from the vertex shader
+in vec2 corner_interp;
+in float life_interp;
+
+// Output color
+out vec4 frag_color;
+
+void main()
+{
+    // Soft round dot
+    float falloff = max(0.0, 1.0 - dot(corner_interp, corner_interp));
+
+    // Hot yellow when born, cooling to the orange of the old flames, fading out at the end of its life
+    vec3 color = mix(vec3(1.0, 0.9, 0.5), vec3(0.8, 0.4, 0.01), life_interp);
+
+    // Blending is additive, the color is the light added
+    frag_color = vec4(color * falloff * (1.0 - life_interp), 1.0);
+}
@@ -0,0 +1,41 @@
+// Source code of vertex shader drawing the particles, one instance per particle
+#version 330
+
+// Instance buffer, the particle buffer last written by the update pass
+in vec2 position;
+in vec2 velocity;
+in float age;
+in float lifetime;
+
+// Per-frame data shared by every program (see frame_uniforms.h)
+layout(std140) uniform FrameUniforms {
+    mat4 view_matrix;
+    float time;
+};
+
+// Size of a newborn particle in world units
+const float particle_size = 0.15;
+
+// Attributes forwarded to the fragment shader
+out vec2 corner_interp;
+out float life_interp;
+
+void main()
+{
+    // Dead particles collapse to a point and produce no fragment
+    if (age >= lifetime) {
+        gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+        corner_interp = vec2(0.0);
+        life_interp = 1.0;
+        return;
+    }
+
+    // Corners of a square from the vertex index, as a triangle strip
+    vec2 corner = vec2((gl_VertexID & 1) == 0 ? -1.0 : 1.0, (gl_VertexID & 2) == 0 ? -1.0 : 1.0);
+    float life = age / lifetime;
+    float size = particle_size * (1.0 - 0.5 * life);
+
+    gl_Position = view_matrix * vec4(position + 0.5 * size * corner, 0.0, 1.0);
+    corner_interp = corner;
+    life_interp = life;
+}
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "particle_engine.h"
+#include "profiler.h"
+
+namespace game {
+
+ParticleEngine::ParticleEngine(void)
+{
+    // Don't do work in the constructor, leave it for the Init() function
+    update_ = NULL;
+    draw_ = NULL;
+    buffers_[0] = buffers_[1] = 0;
+    source_ = 0;
+    update_vao_[0] = update_vao_[1] = 0;
+    draw_vao_[0] = draw_vao_[1] = 0;
+    capacity_ = 0;
+    used_ = 0;
+    cursor_ = 0;
+    seed_ = 1;
+    delta_time_uniform_ = -1;
+    capacity_uniform_ = -1;
+    seed_uniform_ = -1;
+    num_bursts_uniform_ = -1;
+    burst_slots_uniform_ = -1;
+    burst_origin_uniform_ = -1;
+    burst_launch_uniform_ = -1;
+}
+
+
+ParticleEngine::~ParticleEngine()
+{
+    if (buffers_[0]) {
+        glDeleteBuffers(2, buffers_);
+        glDeleteVertexArrays(2, update_vao_);
+        glDeleteVertexArrays(2, draw_vao_);
+    }
+}
+
+
+const std::vector<std::string>& ParticleEngine::GetFeedbackVaryings(void)
+{
+    static const std::vector<std::string> varyings = { "out_position", "out_velocity", "out_age", "out_lifetime" };
+    return varyings;
+}
+
+
+void ParticleEngine::Init(Shader &update, Shader &draw, int capacity)
+{
+    if (capacity <= 0) {
+        throw(std::runtime_error(std::string("Particle capacity must be positive")));
+    }
+    update_ = &update;
+    draw_ = &draw;
+    capacity_ = capacity;
+
+    delta_time_uniform_ = update.GetUniform("delta_time");
+    capacity_uniform_ = update.GetUniform("capacity");
+    seed_uniform_ = update.GetUniform("seed");
+    num_bursts_uniform_ = update.GetUniform("num_bursts");
+    burst_slots_uniform_ = update.GetUniform("burst_slots");
+    burst_origin_uniform_ = update.GetUniform("burst_origin");
+    burst_launch_uniform_ = update.GetUniform("burst_launch");
+
+    // Every particle starts dead: zero lifetime, already reached
+    std::vector<Particle> particles(capacity);
+    for (int i = 0; i < capacity; i++) {
+        particles[i].position = glm::vec2(0.0f);
+        particles[i].velocity = glm::vec2(0.0f);
+        particles[i].age = 0.0f;
+        particles[i].lifetime = 0.0f;
+    }
+    glGenBuffers(2, buffers_);
+    for (int i = 0; i < 2; i++) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffers_[i]);
+        glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(Particle), &particles[0], GL_DYNAMIC_COPY);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // The update pass reads one vertex per particle, the draw pass one instance per particle
+    glGenVertexArrays(2, update_vao_);
+    glGenVertexArrays(2, draw_vao_);
+    for (int i = 0; i < 2; i++) {
+        glBindVertexArray(update_vao_[i]);
+        SetAttributes(update, buffers_[i], 0);
+        glBindVertexArray(draw_vao_[i]);
+        SetAttributes(draw, buffers_[i], 1);
+    }
+    glBindVertexArray(0);
+}
+
+
+void ParticleEngine::Emit(const ParticleBurst &burst, const glm::vec2 &position, float direction)
+{
+    int count = std::min(burst.count, capacity_);
+    if (count <= 0) {
+        return;
+    }
+
+    PendingBurst pending;
+    pending.first = cursor_;
+    pending.count = count;
+    pending.origin = glm::vec4(position, direction, burst.spread);
+    pending.launch = glm::vec4(burst.min_speed, burst.max_speed, burst.min_lifetime, burst.max_lifetime);
+    bursts_.push_back(pending);
+
+    // Take over the oldest slots
+    cursor_ = (cursor_ + count) % capacity_;
+    used_ = std::min(capacity_, used_ + count);
+}
+
+
+void ParticleEngine::Update(float delta_time)
+{
+    YUME_PROFILE_ZONE("ParticleEngine::Update");
+    if (used_ == 0) {
+        return;
+    }
+
+    // The shader takes a fixed number of bursts per pass, the passes after the first only spawn
+    RunPass(delta_time, 0, std::min((int) bursts_.size(), MAX_PARTICLE_BURSTS));
+    for (int first = MAX_PARTICLE_BURSTS; first < bursts_.size(); first += MAX_PARTICLE_BURSTS) {
+        RunPass(0.0f, first, std::min((int) bursts_.size() - first, MAX_PARTICLE_BURSTS));
+    }
+    bursts_.clear();
+}
+
+
+void ParticleEngine::RunPass(float delta_time, int first, int count)
+{
+    GLint slots[MAX_PARTICLE_BURSTS * 2];
+    glm::vec4 origin[MAX_PARTICLE_BURSTS];
+    glm::vec4 launch[MAX_PARTICLE_BURSTS];
+    for (int i = 0; i < count; i++) {
+        slots[i * 2] = bursts_[first + i].first;
+        slots[i * 2 + 1] = bursts_[first + i].count;
+        origin[i] = bursts_[first + i].origin;
+        launch[i] = bursts_[first + i].launch;
+    }
+
+    update_->Enable();
+    update_->SetUniform1f(delta_time_uniform_, delta_time);
+    update_->SetUniform1i(capacity_uniform_, capacity_);
+    update_->SetUniform1i(seed_uniform_, seed_++);
+    update_->SetUniform1i(num_bursts_uniform_, count);
+    if (count > 0) {
+        if (burst_slots_uniform_ >= 0) {
+            glUniform2iv(burst_slots_uniform_, count, slots);
+        }
+        if (burst_origin_uniform_ >= 0) {
+            glUniform4fv(burst_origin_uniform_, count, glm::value_ptr(origin[0]));
+        }
+        if (burst_launch_uniform_ >= 0) {
+            glUniform4fv(burst_launch_uniform_, count, glm::value_ptr(launch[0]));
+        }
+    }
+
+    // One point per particle, nothing reaches the rasterizer
+    glBindVertexArray(update_vao_[source_]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers_[1 - source_]);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, used_);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+
+    source_ = 1 - source_;
+}
+
+
+void ParticleEngine::Render(void)
+{
+    YUME_PROFILE_ZONE("ParticleEngine::Render");
+    if (used_ == 0) {
+        return;
+    }
+
+    // One quad per particle, its corners come from gl_VertexID
+    draw_->Enable();
+    glBindVertexArray(draw_vao_[source_]);
+
+    // Glowing particles add up and do not hide each other
+    BeginAdditive();
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, used_);
+    EndAdditive();
+
+    glBindVertexArray(0);
+}
+
+
+void ParticleEngine::BeginAdditive(void)
+{
+    // The sprite batch turns blending off when it flushes, turn it back on
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+}
+
+
+void ParticleEngine::EndAdditive(void)
+{
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_DEPTH_TEST);
+}
+
+
+void ParticleEngine::SetAttributes(Shader &program, GLuint buffer, GLuint divisor)
+{
+    const char *names[4] = { "position", "velocity", "age", "lifetime" };
+    const int sizes[4] = { 2, 2, 1, 1 };
+    const size_t offsets[4] = { offsetof(Particle, position), offsetof(Particle, velocity), offsetof(Particle, age), offsetof(Particle, lifetime) };
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (int i = 0; i < 4; i++) {
+        GLint location = glGetAttribLocation(program.GetShaderID(), names[i]);
+        if (location < 0) {
+            continue;
+        }
+        glVertexAttribPointer(location, sizes[i], GL_FLOAT, GL_FALSE, sizeof(Particle), (void *) offsets[i]);
+        glVertexAttribDivisor(location, divisor);
+        glEnableVertexAttribArray(location);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+} // namespace game
@@ -0,0 +1,122 @@
+#ifndef PARTICLE_ENGINE_H_
+#define PARTICLE_ENGINE_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+#include "shader.h"
+
+namespace game {
+
+    // Largest number of bursts spawned by one update pass, must match particle_update_shader.glsl
+#define MAX_PARTICLE_BURSTS 16
+
+    // How the particles of a burst are launched, each one picks its own values within the ranges
+    struct ParticleBurst {
+        int count;
+        float spread;          // Radians either side of the burst's direction, pi for every direction
+        float min_speed, max_speed;
+        float min_lifetime, max_lifetime;
+    };
+
+    /*
+        ParticleEngine keeps every particle (position, velocity, age, lifetime) in GPU buffers and never reads them back
+        Each update runs the particles through a vertex shader whose outputs are captured with transform feedback
+        into the second buffer, then the two buffers swap roles
+        Bursts are spawned by that same pass: the CPU only hands over where in the ring of particles a burst starts,
+        so emitting and stepping hundreds of thousands of particles costs a few uniforms and two draw calls per frame
+        When the ring is full new bursts replace the oldest particles
+    */
+    class ParticleEngine {
+
+        public:
+            ParticleEngine(void);
+            ~ParticleEngine();
+
+            // Allocate room for capacity particles. update must be linked with GetFeedbackVaryings(), draw is the particle drawing program
+            void Init(Shader &update, Shader &draw, int capacity);
+
+            // Queue a burst at position, launched around direction (radians), spawned by the next Update()
+            void Emit(const ParticleBurst &burst, const glm::vec2 &position, float direction);
+
+            // Age and move every particle by delta_time seconds and spawn the queued bursts
+            void Update(float delta_time);
+
+            // Draw the live particles with additive blending, the view matrix comes from the FrameUniforms block
+            void Render(void);
+
+            // Outputs of the update program, in the order of a particle in the buffers
+            static const std::vector<std::string>& GetFeedbackVaryings(void);
+
+            // One particle in the buffers, must match the update program's outputs
+            // Particles simulated on the CPU are streamed to the draw program in the same layout (see ParticleStream)
+            struct Particle {
+                glm::vec2 position;
+                glm::vec2 velocity;
+                float age;
+                float lifetime;
+            };
+
+            // Point the particle attributes of program at buffer in the bound vertex array, with the given divisor
+            static void SetAttributes(Shader &program, GLuint buffer, GLuint divisor);
+
+            // State of every particle draw: additive blending, no depth test
+            // EndAdditive() goes back to the alpha blending and depth test the game starts with
+            static void BeginAdditive(void);
+            static void EndAdditive(void);
+
+            // Getters
+            inline int GetCapacity(void) const { return capacity_; }
+            inline int GetNumPending(void) const { return bursts_.size(); }
+
+        private:
+            // A queued burst and the slots of the ring it takes over
+            struct PendingBurst {
+                int first;
+                int count;
+                glm::vec4 origin; // position, direction, spread
+                glm::vec4 launch; // speed range, lifetime range
+            };
+
+            Shader *update_;
+            Shader *draw_;
+
+            // Ping-pong buffers, particles are read from buffers_[source_] and written to the other one
+            GLuint buffers_[2];
+            int source_;
+
+            // Vertex arrays of the two passes reading from each buffer, so that their attributes never leak into the sprite programs
+            GLuint update_vao_[2];
+            GLuint draw_vao_[2];
+
+            int capacity_;
+
+            // Slots ever used, nothing past them is stepped or drawn, and where the next burst starts
+            int used_;
+            int cursor_;
+
+            // Seed of the next update pass, varies the launch of every burst
+            unsigned int seed_;
+
+            std::vector<PendingBurst> bursts_;
+
+            // Uniform handles of the update program
+            UniformHandle delta_time_uniform_;
+            UniformHandle capacity_uniform_;
+            UniformHandle seed_uniform_;
+            UniformHandle num_bursts_uniform_;
+            UniformHandle burst_slots_uniform_;
+            UniformHandle burst_origin_uniform_;
+            UniformHandle burst_launch_uniform_;
+
+            // Run one update pass spawning bursts [first, first + count) of the queue
+            void RunPass(float delta_time, int first, int count);
+
+    }; // class ParticleEngine
+
+} // namespace game
+
+#endif // PARTICLE_ENGINE_H_
@@ -0,0 +1,57 @@
+#include <algorithm>
+
+#include "particle_pool.h"
+
+namespace game {
+
+ParticlePool::ParticlePool(int capacity)
+    : position_(capacity), velocity_(capacity), age_(capacity), lifetime_(capacity)
+{
+    count_ = 0;
+}
+
+
+int ParticlePool::Spawn(const glm::vec2& position, const glm::vec2& velocity, float lifetime)
+{
+    if (count_ == position_.size()) {
+        return -1;
+    }
+
+    int i = count_++;
+    position_[i] = position;
+    velocity_[i] = velocity;
+    age_[i] = 0.0f;
+    lifetime_[i] = lifetime;
+    return i;
+}
+
+
+void ParticlePool::Remove(int i)
+{
+    int last = --count_;
+    if (i != last) {
+        position_[i] = position_[last];
+        velocity_[i] = velocity_[last];
+        age_[i] = age_[last];
+        lifetime_[i] = lifetime_[last];
+    }
+}
+
+
+void ParticlePool::Update(float delta_time, float drag)
+{
+    float damping = std::max(0.0f, 1.0f - drag * delta_time);
+
+    // Walk backwards so that the particle moved into a removed one's place was already stepped
+    for (int i = count_ - 1; i >= 0; i--) {
+        age_[i] += delta_time;
+        if (age_[i] >= lifetime_[i]) {
+            Remove(i);
+            continue;
+        }
+        position_[i] += velocity_[i] * delta_time;
+        velocity_[i] *= damping;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,55 @@
+#ifndef PARTICLE_POOL_H_
+#define PARTICLE_POOL_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace game {
+
+    /*
+        ParticlePool holds the particles simulated on the CPU, one contiguous array per field
+        The storage is allocated once for a fixed capacity, spawning and dying never touches the heap
+        Live particles are kept packed at the front: a dead particle is replaced by the last one,
+        so a step walks a dense range however many particles came and went
+    */
+    class ParticlePool {
+
+        public:
+            ParticlePool(int capacity);
+
+            // Add a particle, returns its index or -1 when the pool is full (the particle is dropped)
+            int Spawn(const glm::vec2& position, const glm::vec2& velocity, float lifetime);
+
+            // Remove particle i, the last particle takes its index
+            void Remove(int i);
+
+            // Age and move every particle by delta_time seconds, slowing them by drag (fraction of the velocity lost per second)
+            // Particles past their lifetime are removed
+            void Update(float delta_time, float drag);
+
+            // Remove every particle
+            inline void Clear(void) { count_ = 0; }
+
+            // Field access
+            inline const glm::vec2& GetPosition(int i) const { return position_[i]; }
+            inline const glm::vec2& GetVelocity(int i) const { return velocity_[i]; }
+            inline float GetAge(int i) const { return age_[i]; }
+            inline float GetLifetime(int i) const { return lifetime_[i]; }
+
+            inline int GetCount(void) const { return count_; }
+            inline int GetCapacity(void) const { return position_.size(); }
+
+        private:
+            std::vector<glm::vec2> position_;
+            std::vector<glm::vec2> velocity_;
+            std::vector<float> age_;      // Seconds since the particle was spawned
+            std::vector<float> lifetime_; // Seconds it lives
+
+            // Number of live particles, stored in [0, count_)
+            int count_;
+
+    }; // class ParticlePool
+
+} // namespace game
+
+#endif // PARTICLE_POOL_H_
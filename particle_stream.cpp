@@ -0,0 +1,74 @@
+#include <algorithm>
+
+#include "particle_stream.h"
+#include "profiler.h"
+
+namespace game {
+
+ParticleStream::ParticleStream(void)
+{
+    // Don't do work in the constructor, leave it for the Init() function
+    draw_ = NULL;
+    buffer_ = 0;
+    vao_ = 0;
+    capacity_ = 0;
+}
+
+
+ParticleStream::~ParticleStream()
+{
+    if (buffer_) {
+        glDeleteBuffers(1, &buffer_);
+        glDeleteVertexArrays(1, &vao_);
+    }
+}
+
+
+void ParticleStream::Init(Shader &draw, int capacity)
+{
+    draw_ = &draw;
+    capacity_ = capacity;
+    staging_.resize(capacity);
+
+    glGenBuffers(1, &buffer_);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer_);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(ParticleEngine::Particle), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenVertexArrays(1, &vao_);
+    glBindVertexArray(vao_);
+    ParticleEngine::SetAttributes(draw, buffer_, 1);
+    glBindVertexArray(0);
+}
+
+
+void ParticleStream::Render(const ParticlePool &particles)
+{
+    YUME_PROFILE_ZONE("ParticleStream::Render");
+    int count = std::min(particles.GetCount(), capacity_);
+    if (count == 0) {
+        return;
+    }
+
+    for (int i = 0; i < count; i++) {
+        staging_[i].position = particles.GetPosition(i);
+        staging_[i].velocity = particles.GetVelocity(i);
+        staging_[i].age = particles.GetAge(i);
+        staging_[i].lifetime = particles.GetLifetime(i);
+    }
+
+    // Orphan last frame's storage so that the upload does not wait for its draw
+    glBindBuffer(GL_ARRAY_BUFFER, buffer_);
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(ParticleEngine::Particle), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(ParticleEngine::Particle), &staging_[0]);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    draw_->Enable();
+    glBindVertexArray(vao_);
+    ParticleEngine::BeginAdditive();
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
+    ParticleEngine::EndAdditive();
+    glBindVertexArray(0);
+}
+
+} // namespace game
@@ -0,0 +1,45 @@
+#ifndef PARTICLE_STREAM_H_
+#define PARTICLE_STREAM_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <vector>
+
+#include "particle_engine.h"
+#include "particle_pool.h"
+#include "shader.h"
+
+namespace game {
+
+    /*
+        ParticleStream draws the particles simulated on the CPU
+        Every frame the whole pool is packed into one buffer, orphaning last frame's storage, and drawn with a single
+        instanced call of the GPU particles' draw program
+    */
+    class ParticleStream {
+
+        public:
+            ParticleStream(void);
+            ~ParticleStream();
+
+            // Create the stream buffer for up to capacity particles, draw is the particle drawing program
+            void Init(Shader &draw, int capacity);
+
+            // Upload and draw every particle of the pool with additive blending
+            void Render(const ParticlePool &particles);
+
+        private:
+            Shader *draw_;
+
+            GLuint buffer_;
+            GLuint vao_;
+            int capacity_;
+
+            // The frame's particles packed in the layout of the draw program
+            std::vector<ParticleEngine::Particle> staging_;
+
+    }; // class ParticleStream
+
+} // namespace game
+
+#endif // PARTICLE_STREAM_H_
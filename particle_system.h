@@ -2,6 +2,7 @@
 #define PARTICLE_SYSTEM_H_
 
 #include "game_object.h"
+#include "shader.h"
 
 namespace game {
 
@@ -9,15 +10,19 @@ namespace game {
     class ParticleSystem : public GameObject {
 
         public:
-            ParticleSystem(const glm::vec3 &position, GLuint texture, GameObject *parent);
+            ParticleSystem(EntityStore& store, const glm::vec3 &position, GLuint texture, GameObject *parent);
 
-            void Update(double delta_time) override;
+            void Update(double delta_time, double current_time) override;
 
-            void Render(Shader& shader, glm::mat4 view_matrix, double current_time);
+            // The view matrix and time come from the FrameUniforms block
+            void Render(Shader& shader);
 
         private:
             GameObject *parent_;
 
+            // Particles are drawn by their own program from a plain 2D texture, not from the sprite atlas
+            GLuint texture_;
+
     }; // class ParticleSystem
 
 } // namespace game
@@ -0,0 +1,75 @@
+// Source code of vertex shader stepping the particles, its outputs are captured with transform feedback
+#version 330
+
+// Must match MAX_PARTICLE_BURSTS in particle_engine.h
+#define MAX_BURSTS 16
+
+// One particle of the source buffer
+in vec2 position;
+in vec2 velocity;
+in float age;
+in float lifetime;
+
+// Seconds to step
+uniform float delta_time;
+
+// Slots in the ring of particles and the seed of this pass
+uniform int capacity;
+uniform int seed;
+
+// Bursts to spawn: first slot and count, then position, direction and spread, then speed and lifetime ranges
+uniform int num_bursts;
+uniform ivec2 burst_slots[MAX_BURSTS];
+uniform vec4 burst_origin[MAX_BURSTS];
+uniform vec4 burst_launch[MAX_BURSTS];
+
+// Fraction of the velocity lost per second
+const float drag = 1.5;
+
+// The particle written to the destination buffer
+out vec2 out_position;
+out vec2 out_velocity;
+out float out_age;
+out float out_lifetime;
+
+// Hash of a slot, a pass and a channel to [0, 1)
+float Random(int slot, int channel)
+{
+    uint n = uint(slot) * 747796405u + uint(seed) * 2891336453u + uint(channel) * 277803737u;
+    n = ((n >> ((n >> 28u) + 4u)) ^ n) * 277803737u;
+    n = (n >> 22u) ^ n;
+    return float(n) / 4294967296.0;
+}
+
+void main()
+{
+    int slot = gl_VertexID;
+
+    // The newest burst covering the slot replaces the particle in it
+    for (int i = num_bursts - 1; i >= 0; i--) {
+        int offset = (slot - burst_slots[i].x + capacity) % capacity;
+        if (offset < burst_slots[i].y) {
+            float angle = burst_origin[i].z + burst_origin[i].w * (2.0 * Random(slot, 0) - 1.0);
+            float speed = mix(burst_launch[i].x, burst_launch[i].y, Random(slot, 1));
+            out_position = burst_origin[i].xy;
+            out_velocity = speed * vec2(cos(angle), sin(angle));
+            out_age = 0.0;
+            out_lifetime = mix(burst_launch[i].z, burst_launch[i].w, Random(slot, 2));
+            return;
+        }
+    }
+
+    // Dead particles keep their slot until a burst takes it over
+    if (age >= lifetime) {
+        out_position = position;
+        out_velocity = velocity;
+        out_age = age;
+        out_lifetime = lifetime;
+        return;
+    }
+
+    out_position = position + velocity * delta_time;
+    out_velocity = velocity * max(0.0, 1.0 - drag * delta_time);
+    out_age = age + delta_time;
+    out_lifetime = lifetime;
+}
@@ -1,5 +1,5 @@
 // Source code of vertex shader for particle system
-#version 130
+#version 330
 
 // Vertex buffer
 in vec2 vertex;
@@ -9,8 +9,12 @@ in vec2 uv;
 
 // Uniform (global) buffer
 uniform mat4 transformation_matrix;
-uniform mat4 view_matrix;
-uniform float time;
+
+// Per-frame data shared by every program (see frame_uniforms.h)
+layout(std140) uniform FrameUniforms {
+    mat4 view_matrix;
+    float time;
+};
 
 // Attributes forwarded to the fragment shader
 out vec4 color_interp;
@@ -9,10 +9,14 @@ namespace game {
     class PenguinGameObject : public GameObject {
 
     public:
-        PenguinGameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable, float mass, std::string state);
+        PenguinGameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable, float mass, std::string state);
 
         // Update function for moving the player object around
-        void Update(double delta_time) override;
+        void Update(double delta_time, double current_time) override;
+
+    protected:
+        // A patrol has a closed form, a woken object lands where it would have been
+        void FastForward(double start_time, int num_steps, double timestep) override;
 
     }; // class PenguinGameObject
 
@@ -9,13 +9,14 @@ namespace game {
 	It overrides GameObject's update method, so that you can check for input to change the velocity of the player
 */
 
-PlayerGameObject::PlayerGameObject(const glm::vec3 &position, GLuint texture, GLint num_elements, bool collidable)
-	: GameObject(position, texture, num_elements, collidable) {
-	velocity_ = glm::vec3(0.0f, 0.001f, 0.0f);
+PlayerGameObject::PlayerGameObject(EntityStore& store, const glm::vec3 &position, const AtlasRegion& sprite, int num_elements, bool collidable)
+	: GameObject(store, position, sprite, num_elements, collidable) {
+	type_ = OBJECT_PLAYER;
+	SetVelocity(glm::vec3(0.0f, 0.001f, 0.0f), true);
 }
 
 // Update function for moving the player object around
-void PlayerGameObject::Update(double delta_time) {
+void PlayerGameObject::Update(double delta_time, double current_time) {
 	// Special player updates go here
 
 	//std::cout << "position: " << glm::to_string(GetPosition()) << std::endl;
@@ -23,13 +24,14 @@ void PlayerGameObject::Update(double delta_time) {
 	//std::cout << "angle: " << angle << std::endl;
 	//std::cout << "velocity: " << glm::to_string(velocity_) << std::endl;
 	//std::cout << "position: " << glm::to_string(position_) << std::endl;
-	float length = glm::length(velocity_);
+	float length = glm::length(GetVelocity());
+	float angle = GetAngle();
 
-	glm::vec3 temp = glm::vec3 (length * glm::cos(glm::radians(angle_ + 90.0f)), length * glm::sin(glm::radians(angle_ + 90.0f)), 0.0f);
-	velocity_ = temp;
+	glm::vec3 temp = glm::vec3 (length * glm::cos(glm::radians(angle + 90.0f)), length * glm::sin(glm::radians(angle + 90.0f)), 0.0f);
+	SetVelocity(temp, true);
 
 	// Call the parent's update method to move the object in standard way, if desired
-	GameObject::Update(delta_time);
+	GameObject::Update(delta_time, current_time);
 }
 
 } // namespace game
@@ -0,0 +1,85 @@
+#include "profiler.h"
+
+#ifdef YUME_PROFILE
+
+#include <fstream>
+#include <iomanip>
+#include <ios>
+
+namespace game {
+
+std::mutex Profiler::mutex_;
+std::vector<Profiler::ThreadBuffer*> Profiler::buffers_;
+const std::chrono::steady_clock::time_point Profiler::epoch_ = std::chrono::steady_clock::now();
+
+
+long long Profiler::Now(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count();
+}
+
+
+Profiler::ThreadBuffer* Profiler::GetThreadBuffer(void)
+{
+    static thread_local ThreadBuffer* buffer = NULL;
+    if (!buffer) {
+        // Only the first zone of each thread takes the lock
+        buffer = new ThreadBuffer();
+        buffer->count = 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->thread_id = buffers_.size();
+        buffers_.push_back(buffer);
+    }
+    return buffer;
+}
+
+
+void Profiler::Record(const char* name, long long start, long long end)
+{
+    ThreadBuffer* buffer = GetThreadBuffer();
+    unsigned long long count = buffer->count.load(std::memory_order_relaxed);
+    Zone& zone = buffer->zones[count % RING_SIZE];
+    zone.name = name;
+    zone.start = start;
+    zone.end = end;
+
+    // Publish the zone to Dump()
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+
+void Profiler::Dump(const std::string& filename)
+{
+    std::ofstream out(filename.c_str());
+    if (out.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + filename));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (int b = 0; b < buffers_.size(); b++) {
+        ThreadBuffer* buffer = buffers_[b];
+        unsigned long long count = buffer->count.load(std::memory_order_acquire);
+        unsigned long long oldest = count > RING_SIZE ? count - RING_SIZE : 0;
+
+        for (unsigned long long i = oldest; i < count; i++) {
+            const Zone& zone = buffer->zones[i % RING_SIZE];
+
+            // Complete events, times in microseconds
+            out << (first ? "" : ",") << "\n{\"name\":\"" << zone.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->thread_id
+                << ",\"ts\":" << zone.start / 1000.0 << ",\"dur\":" << (zone.end - zone.start) / 1000.0 << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+
+    if (out.fail()) {
+        throw(std::ios_base::failure(std::string("Error writing file ") + filename));
+    }
+}
+
+} // namespace game
+
+#endif // YUME_PROFILE
@@ -0,0 +1,87 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+/*
+    Scoped-zone frame profiler
+    Mark a block with YUME_PROFILE_ZONE("name"): the time between the marker and the end of the block is recorded
+    into a ring buffer owned by the calling thread, so recording takes no lock
+    Profiler::Dump() writes the recorded zones of every thread as a chrome://tracing / Perfetto JSON file
+    Without the YUME_PROFILE build option (cmake -DYUME_PROFILE=ON) the markers compile to nothing
+*/
+
+#ifdef YUME_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace game {
+
+    class Profiler {
+
+        public:
+            // One recorded zone, name must be a string literal
+            struct Zone {
+                const char* name;
+                long long start; // Nanoseconds since the profiler started
+                long long end;
+            };
+
+            // Most recent zones kept per thread, older ones are overwritten
+            static const int RING_SIZE = 1 << 16;
+
+            // Record a zone on the calling thread
+            static void Record(const char* name, long long start, long long end);
+
+            // Nanoseconds since the profiler started
+            static long long Now(void);
+
+            // Write the zones recorded so far to filename, throws std::ios_base::failure if it cannot be written
+            // Zones being recorded while the file is written may come out torn, dump between frames or at exit
+            static void Dump(const std::string& filename);
+
+        private:
+            // Ring buffer of one thread, written by that thread only
+            struct ThreadBuffer {
+                int thread_id;
+                std::atomic<unsigned long long> count; // Zones ever recorded, the next one goes at count % RING_SIZE
+                Zone zones[RING_SIZE];
+            };
+
+            // The calling thread's buffer, registered on first use and kept after the thread exits
+            static ThreadBuffer* GetThreadBuffer(void);
+
+            static std::mutex mutex_;
+            static std::vector<ThreadBuffer*> buffers_;
+            static const std::chrono::steady_clock::time_point epoch_;
+
+    }; // class Profiler
+
+    // Records the zone from its construction to its destruction
+    class ProfileZone {
+
+        public:
+            inline ProfileZone(const char* name) : name_(name), start_(Profiler::Now()) {}
+            inline ~ProfileZone() { Profiler::Record(name_, start_, Profiler::Now()); }
+
+        private:
+            const char* name_;
+            long long start_;
+
+    }; // class ProfileZone
+
+} // namespace game
+
+#define YUME_PROFILE_CONCAT_(a, b) a##b
+#define YUME_PROFILE_CONCAT(a, b) YUME_PROFILE_CONCAT_(a, b)
+#define YUME_PROFILE_ZONE(name) game::ProfileZone YUME_PROFILE_CONCAT(profile_zone_, __LINE__)(name)
+
+#else
+
+#define YUME_PROFILE_ZONE(name) ((void) 0)
+
+#endif // YUME_PROFILE
+
+#endif // PROFILER_H_
@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "program_cache.h"
+
+namespace game {
+
+// 64-bit FNV-1a, continued from hash
+static unsigned long long Hash(const std::string& data, unsigned long long hash)
+{
+    for (int i = 0; i < data.size(); i++) {
+        hash ^= (unsigned char) data[i];
+        hash *= 1099511628211ULL;
+    }
+
+    // Separates consecutive strings, so that moving text from one to the next changes the key
+    hash ^= 0xff;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+
+ProgramCache::ProgramCache(void)
+{
+    // Don't do work in the constructor, leave it for the Init() function
+    enabled_ = false;
+    num_hits_ = 0;
+    num_misses_ = 0;
+}
+
+
+void ProgramCache::Init(const std::string& directory)
+{
+    directory_ = directory;
+    num_hits_ = 0;
+    num_misses_ = 0;
+
+    // A binary only fits the driver that wrote it
+    const char *strings[3] = { (const char *) glGetString(GL_VENDOR), (const char *) glGetString(GL_RENDERER), (const char *) glGetString(GL_VERSION) };
+    driver_.clear();
+    for (int i = 0; i < 3; i++) {
+        driver_ += std::string(strings[i] ? strings[i] : "") + "|";
+    }
+
+    GLint num_formats = 0;
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+    }
+    enabled_ = num_formats > 0;
+}
+
+
+unsigned long long ProgramCache::MakeKey(const std::string& vertex_source, const std::string& fragment_source, const std::vector<std::string>& feedback_varyings) const
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    hash = Hash(driver_, hash);
+    hash = Hash(vertex_source, hash);
+    hash = Hash(fragment_source, hash);
+    for (int i = 0; i < feedback_varyings.size(); i++) {
+        hash = Hash(feedback_varyings[i], hash);
+    }
+    return hash;
+}
+
+
+std::string ProgramCache::GetFilename(unsigned long long key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "program_%016llx.bin", key);
+    return directory_ + "/" + name;
+}
+
+
+bool ProgramCache::Load(unsigned long long key, GLuint program)
+{
+    if (!enabled_) {
+        num_misses_++;
+        return false;
+    }
+
+    std::ifstream f(GetFilename(key).c_str(), std::ios::binary);
+    ProgramCacheFileHeader header;
+    f.read((char *) &header, sizeof(header));
+    if (!f || strncmp(header.magic, PROGRAM_CACHE_MAGIC, 4) != 0 || header.version != PROGRAM_CACHE_VERSION || header.key != key) {
+        num_misses_++;
+        return false;
+    }
+
+    std::vector<char> binary(header.length);
+    f.read(binary.data(), binary.size());
+    if (!f) {
+        num_misses_++;
+        return false;
+    }
+
+    // The driver checks the binary itself, and rejects it after an update for instance
+    glProgramBinary(program, header.format, binary.data(), binary.size());
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        num_misses_++;
+        return false;
+    }
+    num_hits_++;
+    return true;
+}
+
+
+void ProgramCache::Store(unsigned long long key, GLuint program)
+{
+    if (!enabled_) {
+        return;
+    }
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    ProgramCacheFileHeader header;
+    memcpy(header.magic, PROGRAM_CACHE_MAGIC, 4);
+    header.version = PROGRAM_CACHE_VERSION;
+    header.key = key;
+    header.format = format;
+    header.length = length;
+
+    std::ofstream out(GetFilename(key).c_str(), std::ios::binary);
+    out.write((const char *) &header, sizeof(header));
+    out.write(binary.data(), length);
+}
+
+} // namespace game
@@ -0,0 +1,68 @@
+#ifndef PROGRAM_CACHE_H_
+#define PROGRAM_CACHE_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <string>
+#include <vector>
+
+namespace game {
+
+    // Layout of a cached program file: the header, then length bytes of program binary in the given format
+#define PROGRAM_CACHE_MAGIC "YPRG"
+#define PROGRAM_CACHE_VERSION 1
+
+    struct ProgramCacheFileHeader {
+        char magic[4];
+        unsigned int version;
+        unsigned long long key;  // Also in the file name, guards against a file renamed by hand
+        unsigned int format;     // As returned by glGetProgramBinary
+        unsigned int length;
+    };
+
+    /*
+        ProgramCache keeps linked shader programs on disk as driver binaries (glGetProgramBinary), one file per program
+        The key of a program hashes its sources, its transform feedback outputs and the driver (vendor, renderer, version),
+        so editing a shader or updating the driver simply misses the cache
+        A driver may still refuse a binary it wrote, loading then fails and the program is compiled from source again
+        Does nothing on drivers without any binary format
+    */
+    class ProgramCache {
+
+        public:
+            ProgramCache(void);
+
+            // Keep the programs in directory, which must exist. Needs a current OpenGL context
+            void Init(const std::string& directory);
+
+            // Key of the program built from these sources
+            unsigned long long MakeKey(const std::string& vertex_source, const std::string& fragment_source, const std::vector<std::string>& feedback_varyings) const;
+
+            // Load the binary stored under key into program, returns whether program is now linked
+            bool Load(unsigned long long key, GLuint program);
+
+            // Store the binary of program under key, program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+            // Failing to write the file only costs a compile on the next start
+            void Store(unsigned long long key, GLuint program);
+
+            // Whether the driver can hand out program binaries
+            inline bool IsEnabled(void) const { return enabled_; }
+
+            // Programs loaded from the cache and programs that had to be compiled since Init()
+            inline int GetNumHits(void) const { return num_hits_; }
+            inline int GetNumMisses(void) const { return num_misses_; }
+
+        private:
+            std::string directory_;
+            std::string driver_;
+            bool enabled_;
+            int num_hits_;
+            int num_misses_;
+
+            std::string GetFilename(unsigned long long key) const;
+
+    }; // class ProgramCache
+
+} // namespace game
+
+#endif // PROGRAM_CACHE_H_
@@ -0,0 +1,42 @@
+#include "projectile_pool.h"
+
+namespace game {
+
+ProjectilePool::ProjectilePool(int capacity)
+    : position_(capacity), velocity_(capacity), angle_(capacity), lifetime_(capacity), owner_(capacity), kind_(capacity)
+{
+    count_ = 0;
+}
+
+
+int ProjectilePool::Spawn(ProjectileKind kind, const glm::vec3& position, const glm::vec3& velocity, float angle, float lifetime, EntityHandle owner)
+{
+    if (count_ == position_.size()) {
+        return -1;
+    }
+
+    int i = count_++;
+    position_[i] = position;
+    velocity_[i] = velocity;
+    angle_[i] = angle;
+    lifetime_[i] = lifetime;
+    owner_[i] = owner;
+    kind_[i] = kind;
+    return i;
+}
+
+
+void ProjectilePool::Remove(int i)
+{
+    int last = --count_;
+    if (i != last) {
+        position_[i] = position_[last];
+        velocity_[i] = velocity_[last];
+        angle_[i] = angle_[last];
+        lifetime_[i] = lifetime_[last];
+        owner_[i] = owner_[last];
+        kind_[i] = kind_[last];
+    }
+}
+
+} // namespace game
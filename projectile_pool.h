@@ -0,0 +1,64 @@
+#ifndef PROJECTILE_POOL_H_
+#define PROJECTILE_POOL_H_
+
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "entity_store.h"
+
+namespace game {
+
+    // Kinds of projectiles
+    enum ProjectileKind {
+        PROJECTILE_BULLET, // Stops at the first enemy it hits
+        PROJECTILE_ARROW   // Goes through every enemy in its way
+    };
+
+    /*
+        ProjectilePool holds every bullet and arrow in flight, one contiguous array per field
+        The storage is allocated once for a fixed capacity, firing and removing never touches the heap
+        Live projectiles are kept packed at the front: removing one moves the last one into its place,
+        so indices are only stable until the next removal
+    */
+    class ProjectilePool {
+
+        public:
+            ProjectilePool(int capacity);
+
+            // Add a projectile, returns its index or -1 when the pool is full (the shot is dropped)
+            int Spawn(ProjectileKind kind, const glm::vec3& position, const glm::vec3& velocity, float angle, float lifetime, EntityHandle owner);
+
+            // Remove projectile i, the last projectile takes its index
+            void Remove(int i);
+
+            // Remove every projectile
+            inline void Clear(void) { count_ = 0; }
+
+            // Field access
+            inline glm::vec3& GetPosition(int i) { return position_[i]; }
+            inline const glm::vec3& GetPosition(int i) const { return position_[i]; }
+            inline const glm::vec3& GetVelocity(int i) const { return velocity_[i]; }
+            inline float GetAngle(int i) const { return angle_[i]; }
+            inline float& GetLifetime(int i) { return lifetime_[i]; }
+            inline EntityHandle GetOwner(int i) const { return owner_[i]; }
+            inline ProjectileKind GetKind(int i) const { return (ProjectileKind) kind_[i]; }
+
+            inline int GetCount(void) const { return count_; }
+            inline int GetCapacity(void) const { return position_.size(); }
+
+        private:
+            std::vector<glm::vec3> position_;
+            std::vector<glm::vec3> velocity_;
+            std::vector<float> angle_;
+            std::vector<float> lifetime_; // Seconds left before the projectile disappears
+            std::vector<EntityHandle> owner_;
+            std::vector<unsigned char> kind_;
+
+            // Number of live projectiles, stored in [0, count_)
+            int count_;
+
+    }; // class ProjectilePool
+
+} // namespace game
+
+#endif // PROJECTILE_POOL_H_
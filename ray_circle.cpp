@@ -0,0 +1,182 @@
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "ray_circle.h"
+
+namespace game {
+
+std::pair<float, float> RayCircleCollisionMath(glm::vec3 bulletPosition, glm::vec3 bulletVelocity, glm::vec3 circlePosition, float radius)
+{
+    float w = bulletPosition.x; //P.x
+    float x = bulletVelocity.x; //d.x
+    float y = bulletPosition.y; //P.y
+    float z = bulletVelocity.y; //d.y
+    float r = radius;
+    float a = circlePosition.x;
+    float b = circlePosition.y;
+
+    float leftSide = -x*w+a*x-y*z+b*z;
+    float discriminant = sqrt(x*x*r*r+2*b*x*x*y-b*b*x*x-x*x*y*y+2*a*b*x*z+2*x*y*z*w-2*a*x*y*z-2*b*x*z*w+2*a*z*z*w+z*z*r*r-a*a*z*z-z*z*w*w);
+    float divisor = x * x + z * z;
+
+    float t1 = (leftSide + discriminant) / divisor;
+    float t2 = (leftSide - discriminant) / divisor;
+
+    std::pair<float, float> pair;
+    pair.first = t1;
+    pair.second = t2;
+    return pair;
+}
+
+
+bool RayCircleHit(const glm::vec2& origin, const glm::vec2& direction, const glm::vec2& center, float radius, float max_t, float& t)
+{
+    glm::vec2 f = origin - center;
+
+    // Already inside
+    float c = glm::dot(f, f) - radius * radius;
+    if (c <= 0.0f) {
+        t = 0.0f;
+        return true;
+    }
+
+    // Moving away or not moving
+    float b = glm::dot(f, direction);
+    if (b >= 0.0f) {
+        return false;
+    }
+
+    // Missing the circle
+    float a = glm::dot(direction, direction);
+    float discriminant = b * b - a * c;
+    if (discriminant < 0.0f) {
+        return false;
+    }
+
+    // b < 0, so the denominator never cancels
+    t = c / (-b + std::sqrt(discriminant));
+    return t <= max_t;
+}
+
+
+// Keep the earliest of the hits found in one block of lanes, given as a bit mask
+static inline void ReduceLanes(const float* lane_t, int mask, int first, int lanes, float* hit_times, int& best, float& best_t)
+{
+    for (int k = 0; k < lanes; k++) {
+        bool hit = (mask >> k) & 1;
+        if (hit_times) {
+            hit_times[first + k] = hit ? lane_t[k] : -1.0f;
+        }
+        if (hit && (best < 0 || lane_t[k] < best_t)) {
+            best = first + k;
+            best_t = lane_t[k];
+        }
+    }
+}
+
+
+int RayCirclesEarliestHit(const glm::vec2& origin, const glm::vec2& direction, const CircleSet& circles, float max_t, float& t, float* hit_times)
+{
+    const int count = circles.GetCount();
+    const float* center_x = count ? &circles.center_x[0] : NULL;
+    const float* center_y = count ? &circles.center_y[0] : NULL;
+    const float* radius = count ? &circles.radius[0] : NULL;
+    const float a = glm::dot(direction, direction);
+
+    int best = -1;
+    float best_t = 0.0f;
+    int i = 0;
+
+#if defined(__AVX__)
+    {
+        const __m256 ox = _mm256_set1_ps(origin.x);
+        const __m256 oy = _mm256_set1_ps(origin.y);
+        const __m256 dx = _mm256_set1_ps(direction.x);
+        const __m256 dy = _mm256_set1_ps(direction.y);
+        const __m256 va = _mm256_set1_ps(a);
+        const __m256 vmax = _mm256_set1_ps(max_t);
+        const __m256 zero = _mm256_setzero_ps();
+        float lane_t[8];
+
+        for (; i + 8 <= count; i += 8) {
+            __m256 fx = _mm256_sub_ps(ox, _mm256_loadu_ps(center_x + i));
+            __m256 fy = _mm256_sub_ps(oy, _mm256_loadu_ps(center_y + i));
+            __m256 r = _mm256_loadu_ps(radius + i);
+            __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(fx, fx), _mm256_mul_ps(fy, fy)), _mm256_mul_ps(r, r));
+            __m256 b = _mm256_add_ps(_mm256_mul_ps(fx, dx), _mm256_mul_ps(fy, dy));
+            __m256 discriminant = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(va, c));
+
+            // Lanes that miss may divide by zero or take the root of a negative number, they are masked out
+            __m256 entry = _mm256_div_ps(c, _mm256_sub_ps(_mm256_sqrt_ps(_mm256_max_ps(discriminant, zero)), b));
+            __m256 inside = _mm256_cmp_ps(c, zero, _CMP_LE_OQ);
+            __m256 crossing = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(b, zero, _CMP_LT_OQ), _mm256_cmp_ps(discriminant, zero, _CMP_GE_OQ)),
+                                            _mm256_cmp_ps(entry, vmax, _CMP_LE_OQ));
+            int mask = _mm256_movemask_ps(_mm256_or_ps(inside, crossing));
+            if (mask == 0 && !hit_times) {
+                continue;
+            }
+
+            _mm256_storeu_ps(lane_t, _mm256_blendv_ps(entry, zero, inside));
+            ReduceLanes(lane_t, mask, i, 8, hit_times, best, best_t);
+        }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    {
+        const __m128 ox = _mm_set1_ps(origin.x);
+        const __m128 oy = _mm_set1_ps(origin.y);
+        const __m128 dx = _mm_set1_ps(direction.x);
+        const __m128 dy = _mm_set1_ps(direction.y);
+        const __m128 va = _mm_set1_ps(a);
+        const __m128 vmax = _mm_set1_ps(max_t);
+        const __m128 zero = _mm_setzero_ps();
+        float lane_t[4];
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 fx = _mm_sub_ps(ox, _mm_loadu_ps(center_x + i));
+            __m128 fy = _mm_sub_ps(oy, _mm_loadu_ps(center_y + i));
+            __m128 r = _mm_loadu_ps(radius + i);
+            __m128 c = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(fx, fx), _mm_mul_ps(fy, fy)), _mm_mul_ps(r, r));
+            __m128 b = _mm_add_ps(_mm_mul_ps(fx, dx), _mm_mul_ps(fy, dy));
+            __m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(va, c));
+
+            // Lanes that miss may divide by zero or take the root of a negative number, they are masked out
+            __m128 entry = _mm_div_ps(c, _mm_sub_ps(_mm_sqrt_ps(_mm_max_ps(discriminant, zero)), b));
+            __m128 inside = _mm_cmple_ps(c, zero);
+            __m128 crossing = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(b, zero), _mm_cmpge_ps(discriminant, zero)), _mm_cmple_ps(entry, vmax));
+            int mask = _mm_movemask_ps(_mm_or_ps(inside, crossing));
+            if (mask == 0 && !hit_times) {
+                continue;
+            }
+
+            // SSE2 has no blend: inside lanes take 0
+            _mm_storeu_ps(lane_t, _mm_andnot_ps(inside, entry));
+            ReduceLanes(lane_t, mask, i, 4, hit_times, best, best_t);
+        }
+    }
+#endif
+
+    // Scalar fallback and the circles left over after the last full block
+    for (; i < count; i++) {
+        float circle_t;
+        bool hit = RayCircleHit(origin, direction, glm::vec2(center_x[i], center_y[i]), radius[i], max_t, circle_t);
+        if (hit_times) {
+            hit_times[i] = hit ? circle_t : -1.0f;
+        }
+        if (hit && (best < 0 || circle_t < best_t)) {
+            best = i;
+            best_t = circle_t;
+        }
+    }
+
+    if (best >= 0) {
+        t = best_t;
+    }
+    return best;
+}
+
+} // namespace game
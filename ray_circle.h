@@ -0,0 +1,43 @@
+#ifndef RAY_CIRCLE_H_
+#define RAY_CIRCLE_H_
+
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+    /*
+        Ray versus circle tests for projectile hits, in the xy plane
+        A ray is origin + t * direction, a hit is the first t in [0, max_t] at which the ray is inside the circle
+        (t = 0 when the origin already is)
+        Entry times use the stable form t = c / (-b + sqrt(b^2 - a c)), which does not cancel when the ray is
+        long compared to the distance to the circle
+    */
+
+    // The original test, solving the expanded polynomial in float, kept as the reference for the accuracy test and the benchmark
+    // Returns both roots, the exit time first, NaN when the ray's line misses the circle
+    std::pair<float, float> RayCircleCollisionMath(glm::vec3 bulletPosition, glm::vec3 bulletVelocity, glm::vec3 circlePosition, float radius = 0.5f);
+
+    // Test one circle, returns whether it is hit and sets t to the entry time
+    bool RayCircleHit(const glm::vec2& origin, const glm::vec2& direction, const glm::vec2& center, float radius, float max_t, float& t);
+
+    // Circles packed one array per field, so that the kernel loads several at once
+    struct CircleSet {
+        std::vector<float> center_x;
+        std::vector<float> center_y;
+        std::vector<float> radius;
+
+        inline int GetCount(void) const { return center_x.size(); }
+        inline void Clear(void) { center_x.clear(); center_y.clear(); radius.clear(); }
+        inline void Add(const glm::vec2& center, float r) { center_x.push_back(center.x); center_y.push_back(center.y); radius.push_back(r); }
+    };
+
+    // Test one ray against every circle of the set in a single pass (AVX or SSE when the build allows, scalar otherwise)
+    // Returns the index of the earliest circle hit, the lowest index on ties, and sets t to its entry time, or returns -1
+    // hit_times, when not NULL, receives the entry time of every circle, or -1 for the circles that are missed
+    int RayCirclesEarliestHit(const glm::vec2& origin, const glm::vec2& direction, const CircleSet& circles, float max_t, float& t, float* hit_times = NULL);
+
+} // namespace game
+
+#endif // RAY_CIRCLE_H_
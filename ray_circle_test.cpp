@@ -0,0 +1,198 @@
+/*
+ *
+ * Accuracy check of the ray-circle kernel, registered with CTest
+ *
+ * Usage: ray_circle_test [number of rays]
+ *
+ * Random rays are tested against random circles of random radii with RayCircleHit, RayCirclesEarliestHit (the SIMD
+ * kernel of the build) and RayCircleCollisionMath, the original expanded-polynomial test
+ * Hit or miss and the earliest circle must agree with RayCircleCollisionMath, entry times must match a
+ * double-precision reference. Circles the ray only grazes, or reaches right at the end of the segment, are left
+ * out of the comparison since rounding alone may decide them
+ *
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "ray_circle.h"
+
+// Largest difference allowed between the entry times of the kernel and of the double-precision reference,
+// on top of what rounding the discriminant to float explains (see ReferenceHit)
+const double max_time_error_g = 1e-4;
+
+// Closer than this to a tangent or to an end of the segment, rounding may decide a hit either way
+const double ambiguity_g = 1e-3;
+
+// Radii of the circles, each one different so that a kernel reading the wrong lane of radii fails
+const float min_radius_g = 0.2f;
+const float max_radius_g = 1.5f;
+
+// Circles around the origin, rays of up to ray_length_g units that start among them
+const int num_circles_g = 1024;
+const float extent_g = 20.0f;
+const float ray_length_g = 16.0f;
+
+
+// Double-precision entry time of the ray into the circle over t in [0, 1], returns whether it is hit
+// ambiguous is set when rounding could decide the outcome, tolerance to the error a float solution may have in t
+static bool ReferenceHit(const glm::vec2& origin, const glm::vec2& direction, const glm::vec2& center, double radius, double& t, bool& ambiguous, double& tolerance)
+{
+    double fx = (double) origin.x - center.x;
+    double fy = (double) origin.y - center.y;
+    double dx = direction.x;
+    double dy = direction.y;
+    double a = dx * dx + dy * dy;
+    double b = fx * dx + fy * dy;
+    double c = fx * fx + fy * fy - radius * radius;
+    double discriminant = b * b - a * c;
+
+    ambiguous = false;
+    tolerance = max_time_error_g;
+    if (discriminant < 0.0) {
+        ambiguous = -discriminant < ambiguity_g * a * radius * radius;
+        return false;
+    }
+    double root = sqrt(discriminant);
+    double t_in = (-b - root) / a;
+    double t_out = (-b + root) / a;
+
+    // Grazing, or entering or leaving right at an end of the segment
+    ambiguous = root < ambiguity_g * sqrt(a) * radius || fabs(t_in - 1.0) < ambiguity_g || fabs(t_out) < ambiguity_g || fabs(t_in) < ambiguity_g;
+    t = std::max(t_in, 0.0);
+
+    // b^2 and a c nearly cancel in the discriminant of a grazing ray, its float rounding error then moves t_in
+    // by about that error over 2 a root
+    tolerance += 4.0 * FLT_EPSILON * b * b / (a * root);
+    return t_in <= 1.0 && t_out >= 0.0;
+}
+
+
+int main(int argc, char **argv)
+{
+    int num_rays = (argc > 1) ? atoi(argv[1]) : 2000;
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(-extent_g, extent_g);
+    std::uniform_real_distribution<float> offset(-ray_length_g, ray_length_g);
+    std::uniform_real_distribution<float> radius(min_radius_g, max_radius_g);
+
+    game::CircleSet circles;
+    for (int i = 0; i < num_circles_g; i++) {
+        glm::vec2 center(coordinate(rng), coordinate(rng));
+        circles.Add(center, radius(rng));
+    }
+
+    long long num_tested = 0;
+    long long num_skipped = 0;
+    long long num_hits = 0;
+    long long hit_mismatches = 0;
+    long long earliest_mismatches = 0;
+    double worst_kernel_error = 0.0;
+    double worst_scalar_error = 0.0;
+    std::vector<float> hit_times(num_circles_g);
+    std::vector<double> reference_times(num_circles_g);
+    std::vector<char> ambiguous(num_circles_g);
+
+    for (int r = 0; r < num_rays; r++) {
+        // Every eighth ray starts inside a circle
+        glm::vec2 origin(coordinate(rng), coordinate(rng));
+        if (r % 8 == 0) {
+            origin = glm::vec2(circles.center_x[r % num_circles_g], circles.center_y[r % num_circles_g]) + glm::vec2(0.1f, -0.2f);
+        }
+        glm::vec2 direction(offset(rng), offset(rng));
+
+        float kernel_t = 0.0f;
+        int kernel_best = game::RayCirclesEarliestHit(origin, direction, circles, 1.0f, kernel_t, &hit_times[0]);
+
+        // Earliest hit according to RayCircleCollisionMath, lowest index on ties
+        int polynomial_best = -1;
+        float polynomial_best_t = 0.0f;
+
+        for (int i = 0; i < num_circles_g; i++) {
+            glm::vec2 center(circles.center_x[i], circles.center_y[i]);
+            float circle_radius = circles.radius[i];
+
+            bool is_ambiguous;
+            double reference_t = 0.0;
+            double tolerance;
+            bool reference_hit = ReferenceHit(origin, direction, center, circle_radius, reference_t, is_ambiguous, tolerance);
+            reference_times[i] = reference_t;
+            ambiguous[i] = is_ambiguous;
+
+            // The roots of RayCircleCollisionMath are NaN for a miss, the first one is the exit
+            std::pair<float, float> roots = game::RayCircleCollisionMath(glm::vec3(origin, 0.0f), glm::vec3(direction, 0.0f), glm::vec3(center, 0.0f), circle_radius);
+            bool polynomial_hit = !std::isnan(roots.first) && roots.first >= 0.0f && roots.second <= 1.0f;
+            if (polynomial_hit) {
+                float entry = std::max(roots.second, 0.0f);
+                if (polynomial_best < 0 || entry < polynomial_best_t) {
+                    polynomial_best = i;
+                    polynomial_best_t = entry;
+                }
+            }
+
+            float scalar_t = 0.0f;
+            bool scalar_hit = game::RayCircleHit(origin, direction, center, circle_radius, 1.0f, scalar_t);
+            bool kernel_hit = hit_times[i] >= 0.0f;
+
+            if (is_ambiguous) {
+                num_skipped++;
+                continue;
+            }
+            num_tested++;
+
+            if (kernel_hit != polynomial_hit || scalar_hit != polynomial_hit || reference_hit != polynomial_hit) {
+                if (hit_mismatches < 10) {
+                    std::cerr << "ray " << r << ", circle " << i << ": kernel " << kernel_hit << ", scalar " << scalar_hit
+                              << ", RayCircleCollisionMath " << polynomial_hit << ", reference " << reference_hit << std::endl;
+                }
+                hit_mismatches++;
+                continue;
+            }
+            if (kernel_hit) {
+                num_hits++;
+                // Errors relative to what rounding explains, 1 is the most allowed
+                worst_kernel_error = std::max(worst_kernel_error, fabs(hit_times[i] - reference_t) / tolerance);
+                worst_scalar_error = std::max(worst_scalar_error, fabs(scalar_t - reference_t) / tolerance);
+            }
+        }
+
+        // The two may only pick different circles when rounding decides between them
+        if (kernel_best != polynomial_best) {
+            bool tie = kernel_best >= 0 && polynomial_best >= 0 && fabs(reference_times[kernel_best] - reference_times[polynomial_best]) < max_time_error_g;
+            bool rounding = (kernel_best >= 0 && ambiguous[kernel_best]) || (polynomial_best >= 0 && ambiguous[polynomial_best]);
+            if (!tie && !rounding) {
+                if (earliest_mismatches < 10) {
+                    std::cerr << "ray " << r << ": earliest circle " << kernel_best << " from the kernel, "
+                              << polynomial_best << " from RayCircleCollisionMath" << std::endl;
+                }
+                earliest_mismatches++;
+            }
+        }
+        else if (kernel_best >= 0 && kernel_t != hit_times[kernel_best]) {
+            std::cerr << "ray " << r << ": entry time " << kernel_t << " differs from hit_times " << hit_times[kernel_best] << std::endl;
+            earliest_mismatches++;
+        }
+    }
+
+#if defined(__AVX__)
+    std::cout << "kernel: AVX" << std::endl;
+#elif defined(__SSE2__) || defined(_M_X64)
+    std::cout << "kernel: SSE2" << std::endl;
+#else
+    std::cout << "kernel: scalar" << std::endl;
+#endif
+    std::cout << "rays: " << num_rays << ", circle tests: " << num_tested << " (" << num_hits << " hits), left out as ambiguous: " << num_skipped << std::endl;
+    std::cout << "hit/miss mismatches: " << hit_mismatches << ", earliest circle mismatches: " << earliest_mismatches << std::endl;
+    std::cout << "worst entry time error, in tolerances: kernel " << worst_kernel_error << ", scalar " << worst_scalar_error << std::endl;
+
+    bool passed = hit_mismatches == 0 && earliest_mismatches == 0 && worst_kernel_error <= 1.0 && worst_scalar_error <= 1.0;
+    std::cout << (passed ? "passed" : "FAILED") << std::endl;
+    return passed ? 0 : 1;
+}
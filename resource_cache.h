@@ -0,0 +1,55 @@
+#ifndef RESOURCE_CACHE_H_
+#define RESOURCE_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace game {
+
+    /*
+        ResourceCache hands out refcounted handles to resources keyed by path, so that every file is read and decoded once
+        The cache itself does not hold a reference: a resource is freed with its last handle and loaded again
+        the next time it is asked for
+        Swapping what an object shows means swapping handles (or atlas regions), which never touches the disk
+    */
+    template <class Resource>
+    class ResourceCache {
+
+        public:
+            typedef std::shared_ptr<Resource> Handle;
+
+            // Handle to the resource stored under key, calling load() to create it if no handle to it is alive
+            // load returns a new Resource, what it throws is passed on and nothing is cached
+            template <class Loader>
+            Handle Get(const std::string& key, Loader load) {
+                typename std::unordered_map<std::string, std::weak_ptr<Resource>>::iterator it = cache_.find(key);
+                if (it != cache_.end()) {
+                    Handle handle = it->second.lock();
+                    if (handle) {
+                        return handle;
+                    }
+                }
+
+                Handle handle(load());
+                cache_[key] = handle;
+                return handle;
+            }
+
+            // Number of resources with at least one live handle
+            int GetNumLoaded(void) const {
+                int count = 0;
+                for (typename std::unordered_map<std::string, std::weak_ptr<Resource>>::const_iterator it = cache_.begin(); it != cache_.end(); ++it) {
+                    count += it->second.expired() ? 0 : 1;
+                }
+                return count;
+            }
+
+        private:
+            std::unordered_map<std::string, std::weak_ptr<Resource>> cache_;
+
+    }; // class ResourceCache
+
+} // namespace game
+
+#endif // RESOURCE_CACHE_H_
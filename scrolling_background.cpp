@@ -0,0 +1,86 @@
+#include <stdexcept>
+#include <string>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "scrolling_background.h"
+
+namespace game {
+
+ScrollingBackground::ScrollingBackground(void)
+{
+    // Don't do work in the constructor, leave it for the Init() function
+    shader_ = NULL;
+    sampler_ = 0;
+    num_layers_ = 0;
+    layers_uniform_ = -1;
+    num_layers_uniform_ = -1;
+    camera_uniform_ = -1;
+    texture_uniform_ = -1;
+}
+
+
+ScrollingBackground::~ScrollingBackground()
+{
+    if (sampler_) {
+        glDeleteSamplers(1, &sampler_);
+    }
+}
+
+
+void ScrollingBackground::Init(Shader &shader)
+{
+    shader_ = &shader;
+    layers_uniform_ = shader.GetUniform("layers");
+    num_layers_uniform_ = shader.GetUniform("num_layers");
+    camera_uniform_ = shader.GetUniform("camera_position");
+    texture_uniform_ = shader.GetUniform("onetex");
+
+    // Wrap across tiles, the atlas texture itself clamps
+    glGenSamplers(1, &sampler_);
+    glSamplerParameteri(sampler_, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glSamplerParameteri(sampler_, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glSamplerParameteri(sampler_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(sampler_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+
+void ScrollingBackground::AddLayer(const AtlasRegion &sprite, float tile_size, float parallax, float opacity)
+{
+    if (num_layers_ == MAX_BACKGROUND_LAYERS) {
+        throw(std::runtime_error(std::string("Too many background layers")));
+    }
+    layers_[num_layers_++] = glm::vec4((float) sprite.layer, tile_size, parallax, opacity);
+}
+
+
+void ScrollingBackground::Render(GLuint texture, const glm::vec3 &camera)
+{
+    if (num_layers_ == 0) {
+        return;
+    }
+
+    shader_->Enable();
+    if (layers_uniform_ >= 0) {
+        glUniform4fv(layers_uniform_, num_layers_, glm::value_ptr(layers_[0]));
+    }
+    shader_->SetUniform1i(num_layers_uniform_, num_layers_);
+    shader_->SetUniform2f(camera_uniform_, glm::vec2(camera));
+    shader_->SetUniform1i(texture_uniform_, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glBindSampler(0, sampler_);
+
+    // Nothing to sort against: the backdrop neither tests nor writes depth
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+
+    // The vertices are generated from gl_VertexID, no buffer needed
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    glDepthMask(GL_TRUE);
+    glEnable(GL_DEPTH_TEST);
+    glBindSampler(0, 0);
+}
+
+} // namespace game
@@ -0,0 +1,60 @@
+#ifndef SCROLLING_BACKGROUND_H_
+#define SCROLLING_BACKGROUND_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "atlas_region.h"
+#include "shader.h"
+
+namespace game {
+
+    // Largest number of layers, must match background_fragment_shader.glsl
+#define MAX_BACKGROUND_LAYERS 4
+
+    /*
+        ScrollingBackground draws the backdrop as one triangle covering the screen
+        The fragment shader maps each pixel back to world space through the view matrix and tiles the layers' sprites
+        over it with GL_REPEAT, so the backdrop has no edge and costs one draw call however far the camera goes
+        Layers are blended in the order they were added, the first one at the back
+    */
+    class ScrollingBackground {
+
+        public:
+            ScrollingBackground(void);
+            ~ScrollingBackground();
+
+            // Create the wrapping sampler. shader must be the background program
+            void Init(Shader &shader);
+
+            // Add a layer showing sprite once every tile_size world units
+            // parallax is how fast the layer follows the world: 1 moves with it, below 1 lags behind as if farther away, 0 stays on screen
+            void AddLayer(const AtlasRegion &sprite, float tile_size, float parallax = 1.0f, float opacity = 1.0f);
+
+            // Draw the layers behind everything else, texture is the sprite atlas and camera the point the view is centered on
+            // The view matrix comes from the FrameUniforms block
+            void Render(GLuint texture, const glm::vec3 &camera);
+
+            inline int GetNumLayers(void) const { return num_layers_; }
+
+        private:
+            Shader *shader_;
+
+            // Sampler bound only while drawing, so that the sprites keep clamping at the atlas' edges
+            GLuint sampler_;
+
+            // Per layer: atlas layer, tile size, parallax, opacity
+            glm::vec4 layers_[MAX_BACKGROUND_LAYERS];
+            int num_layers_;
+
+            UniformHandle layers_uniform_;
+            UniformHandle num_layers_uniform_;
+            UniformHandle camera_uniform_;
+            UniformHandle texture_uniform_;
+
+    }; // class ScrollingBackground
+
+} // namespace game
+
+#endif // SCROLLING_BACKGROUND_H_
@@ -1,7 +1,6 @@
 #include <string>
 #include <iostream>
 #include "seeker_game_object.h"
-#include <GLFW/glfw3.h>
 
 namespace game {
 
@@ -9,17 +8,19 @@ namespace game {
 		SeekerGameObject inherits from GameObject
 	*/
 
-	SeekerGameObject::SeekerGameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable, float mass, std::string state)
-		: GameObject(position, texture, num_elements, collidable, mass, state) {}
+	SeekerGameObject::SeekerGameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable, float mass, std::string state)
+		: GameObject(store, position, sprite, num_elements, collidable, mass, state) {
+		type_ = OBJECT_SEEKER;
+	}
 
 	// Update function for moving the seeker object around
-	void SeekerGameObject::Update(double delta_time) {
+	void SeekerGameObject::Update(double delta_time, double current_time) {
 
 		// Special seeker updates go here
 
 
 		// Call the parent's update method to move the object in standard way, if desired
-		GameObject::Update(delta_time);
+		GameObject::Update(delta_time, current_time);
 	}
 
 } // namespace game
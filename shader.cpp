@@ -11,87 +11,203 @@ Shader::Shader(void)
 {
     // Don't do work in the constructor, leave it for the Init() function
     shader_program_ = 0;
+    vertex_shader_ = 0;
+    fragment_shader_ = 0;
+    pending_ = false;
+    from_cache_ = false;
+    cache_ = NULL;
+    cache_key_ = 0;
     vbo_sprite_ = 0;
     ebo_sprite_ = 0;
     size_sprite_ = 0;
     vbo_particles_ = 0;
     ebo_particles_ = 0;
     size_particles_ = 0;
+    vertex_att_ = -1;
+    color_att_ = -1;
+    uv_att_ = -1;
+    dir_att_ = -1;
+    phase_att_ = -1;
 }
 
 
-void Shader::Init(const char *vertPath, const char *fragPath)
+void Shader::Init(const char *vertPath, const char *fragPath, const std::vector<std::string>& feedback_varyings)
 {
-   
-    // Load shader program source code
-    // Vertex program
+    Begin(vertPath, fragPath, feedback_varyings);
+    Finish();
+}
+
+
+void Shader::Begin(const char *vertPath, const char *fragPath, const std::vector<std::string>& feedback_varyings, ProgramCache *cache)
+{
+
+    // Load shader program source code, transform feedback programs can do without a fragment program
     std::string vp = LoadTextFile(vertPath);
-    const char *source_vp = vp.c_str();
-    // Fragment program
-    std::string fp = LoadTextFile(fragPath);
-    const char *source_fp = fp.c_str();
+    std::string fp = fragPath ? LoadTextFile(fragPath) : std::string();
+    pending_ = true;
+    from_cache_ = false;
+    cache_ = cache;
+
+    // A cached binary is linked as soon as it is loaded
+    if (cache_) {
+        cache_key_ = cache_->MakeKey(vp, fp, feedback_varyings);
+        shader_program_ = glCreateProgram();
+        if (cache_->Load(cache_key_, shader_program_)) {
+            from_cache_ = true;
+            return;
+        }
 
-    // Create a shader from vertex program source code
-    GLuint vs = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vs, 1, &source_vp, NULL);
-    glCompileShader(vs);
-
-    // Check if shader compiled successfully
-    GLint status;
-    glGetShaderiv(vs, GL_COMPILE_STATUS, &status);
-    if (status != GL_TRUE) {
-        char buffer[512];
-        glGetShaderInfoLog(vs, 512, NULL, buffer);
-        throw(std::ios_base::failure(std::string("Error compiling vertex shader: ") + std::string(buffer)));
+        // A refused binary can leave the program in any state, start over from a new one
+        glDeleteProgram(shader_program_);
     }
 
+    // Create a shader from vertex program source code
+    // Compile errors are only checked in Finish(), asking now would wait for the compiler
+    const char *source_vp = vp.c_str();
+    vertex_shader_ = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex_shader_, 1, &source_vp, NULL);
+    glCompileShader(vertex_shader_);
+
     // Create a shader from the fragment program source code
-    GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fs, 1, &source_fp, NULL);
-    glCompileShader(fs);
-
-    // Check if shader compiled successfully
-    glGetShaderiv(fs, GL_COMPILE_STATUS, &status);
-    if (status != GL_TRUE) {
-        char buffer[512];
-        glGetShaderInfoLog(fs, 512, NULL, buffer);
-        throw(std::ios_base::failure(std::string("Error compiling fragment shader: ") + std::string(buffer)));
+    if (fragPath) {
+        const char *source_fp = fp.c_str();
+        fragment_shader_ = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment_shader_, 1, &source_fp, NULL);
+        glCompileShader(fragment_shader_);
     }
 
     // Create a shader program linking both vertex and fragment shaders
     // together
     shader_program_ = glCreateProgram();
-    glAttachShader(shader_program_, vs);
-    glAttachShader(shader_program_, fs);
+    glAttachShader(shader_program_, vertex_shader_);
+    if (fragment_shader_) {
+        glAttachShader(shader_program_, fragment_shader_);
+    }
+
+    // The outputs captured by transform feedback have to be known before linking
+    if (!feedback_varyings.empty()) {
+        std::vector<const GLchar *> names;
+        for (int i = 0; i < feedback_varyings.size(); i++) {
+            names.push_back(feedback_varyings[i].c_str());
+        }
+        glTransformFeedbackVaryings(shader_program_, names.size(), &names[0], GL_INTERLEAVED_ATTRIBS);
+    }
+
+    // Keep the binary available for the cache
+    if (cache_ && cache_->IsEnabled()) {
+        glProgramParameteri(shader_program_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(shader_program_);
+}
+
+
+void Shader::Finish(void)
+{
+    if (!pending_) {
+        return;
+    }
+    pending_ = false;
+
+    if (!from_cache_) {
+        // Check if shaders compiled successfully
+        GLint status;
+        glGetShaderiv(vertex_shader_, GL_COMPILE_STATUS, &status);
+        if (status != GL_TRUE) {
+            char buffer[512];
+            glGetShaderInfoLog(vertex_shader_, 512, NULL, buffer);
+            throw(std::ios_base::failure(std::string("Error compiling vertex shader: ") + std::string(buffer)));
+        }
+        if (fragment_shader_) {
+            glGetShaderiv(fragment_shader_, GL_COMPILE_STATUS, &status);
+            if (status != GL_TRUE) {
+                char buffer[512];
+                glGetShaderInfoLog(fragment_shader_, 512, NULL, buffer);
+                throw(std::ios_base::failure(std::string("Error compiling fragment shader: ") + std::string(buffer)));
+            }
+        }
 
-    // Check if shaders were linked successfully
-    glGetProgramiv(shader_program_, GL_LINK_STATUS, &status);
-    if (status != GL_TRUE) {
-        char buffer[512];
-        glGetShaderInfoLog(shader_program_, 512, NULL, buffer);
-        throw(std::ios_base::failure(std::string("Error linking shaders: ") + std::string(buffer)));
+        // Check if shaders were linked successfully
+        glGetProgramiv(shader_program_, GL_LINK_STATUS, &status);
+        if (status != GL_TRUE) {
+            char buffer[512];
+            glGetProgramInfoLog(shader_program_, 512, NULL, buffer);
+            throw(std::ios_base::failure(std::string("Error linking shaders: ") + std::string(buffer)));
+        }
+
+        // Delete memory used by shaders, since they were already compiled
+        // and linked
+        glDeleteShader(vertex_shader_);
+        if (fragment_shader_) {
+            glDeleteShader(fragment_shader_);
+        }
+        vertex_shader_ = 0;
+        fragment_shader_ = 0;
+
+        // The next start loads the program instead
+        if (cache_) {
+            cache_->Store(cache_key_, shader_program_);
+        }
     }
 
-    // Delete memory used by shaders, since they were already compiled
-    // and linked
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+    // Record every active uniform once, so setting one never asks the driver for its location
+    uniforms_.clear();
+    GLint num_uniforms = 0;
+    glGetProgramiv(shader_program_, GL_ACTIVE_UNIFORMS, &num_uniforms);
+    for (GLint i = 0; i < num_uniforms; i++) {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shader_program_, i, sizeof(name), &length, &size, &type, name);
+
+        // Members of uniform blocks have no location, they are set through the block's buffer
+        GLint location = glGetUniformLocation(shader_program_, name);
+        if (location < 0) {
+            continue;
+        }
 
+        // Arrays are reported as "name[0]", make them reachable by their plain name as well
+        std::string uniform_name(name, length);
+        uniforms_[uniform_name] = location;
+        size_t bracket = uniform_name.find('[');
+        if (bracket != std::string::npos) {
+            uniforms_[uniform_name.substr(0, bracket)] = location;
+        }
+    }
+
+    // Same for the attributes, programs only have some of them
+    vertex_att_ = glGetAttribLocation(shader_program_, "vertex");
+    color_att_ = glGetAttribLocation(shader_program_, "color");
+    uv_att_ = glGetAttribLocation(shader_program_, "uv");
+    dir_att_ = glGetAttribLocation(shader_program_, "dir");
+    phase_att_ = glGetAttribLocation(shader_program_, "t");
 
     // Set attributes for shaders
     // Should be consistent with how we created the buffers for the square
-    GLint vertex_att = glGetAttribLocation(shader_program_, "vertex");
-    glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
-    glEnableVertexAttribArray(vertex_att);
+    if (vertex_att_ >= 0) {
+        glVertexAttribPointer(vertex_att_, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
+        glEnableVertexAttribArray(vertex_att_);
+    }
+
+    // Programs that do not use the vertex color (instanced sprites) have no color attribute
+    if (color_att_ >= 0) {
+        glVertexAttribPointer(color_att_, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(2 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(color_att_);
+    }
+
+    if (uv_att_ >= 0) {
+        glVertexAttribPointer(uv_att_, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(5 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(uv_att_);
+    }
+}
 
-    GLint color_att = glGetAttribLocation(shader_program_, "color");
-    glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(2 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(color_att);
 
-    GLint tex_att = glGetAttribLocation(shader_program_, "uv");
-    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(5 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(tex_att);
+void Shader::BindUniformBlock(const char *name, GLuint binding)
+{
+    GLuint index = glGetUniformBlockIndex(shader_program_, name);
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(shader_program_, index, binding);
+    }
 }
 
 void Shader::CreateSprite(void) {
@@ -131,7 +247,7 @@ void Shader::CreateSprite(void) {
     size_sprite_ = sizeof(face) / sizeof(GLuint);
 }
 
-void Shader::CreateParticles(void)
+void Shader::CreateParticles(int num_particles)
 {
 
     // Each particle is a square with four vertices and two triangles
@@ -155,13 +271,13 @@ void Shader::CreateParticles(void)
         2, 3, 0  // t2
     };
 
-    // Initialize all the particle vertices
-    GLfloat particles[NUM_PARTICLES * vertex_attr];
+    // Initialize all the particle vertices, on the heap since their number is only known at runtime
+    std::vector<GLfloat> particles(num_particles * vertex_attr);
     float theta, r, tmod;
     float pi = glm::pi<float>();
     float two_pi = 2.0f * pi;
 
-    for (int i = 0; i < NUM_PARTICLES; i++) {
+    for (int i = 0; i < num_particles; i++) {
         if (i % 4 == 0) {
             //theta = (two_pi*(rand() % 1000) / 1000.0f);
             theta = (2.0 * (rand() % 10000) / 10000.0f - 1.0f) * 0.13f + pi;
@@ -186,9 +302,9 @@ void Shader::CreateParticles(void)
     }
 
     // Initialize all the particle faces
-    GLuint manyfaces[NUM_PARTICLES * 6];
+    std::vector<GLuint> manyfaces(num_particles * 6);
 
-    for (int i = 0; i < NUM_PARTICLES; i++) {
+    for (int i = 0; i < num_particles; i++) {
         for (int j = 0; j < 6; j++) {
             manyfaces[i * 6 + j] = face[j] + i * 4;
         }
@@ -197,15 +313,15 @@ void Shader::CreateParticles(void)
     // Create buffer for vertices
     glGenBuffers(1, &vbo_particles_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_particles_);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(particles), particles, GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(GLfloat), &particles[0], GL_STATIC_DRAW);
 
     // Create buffer for faces (index buffer)
     glGenBuffers(1, &ebo_particles_);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_particles_);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(manyfaces), manyfaces, GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, manyfaces.size() * sizeof(GLuint), &manyfaces[0], GL_STATIC_DRAW);
 
     // Set number of elements in array buffer
-    size_particles_ = sizeof(manyfaces) / sizeof(GLuint);
+    size_particles_ = manyfaces.size();
 }
 
 void Shader::SetSpriteAttributes(void)
@@ -222,17 +338,20 @@ void Shader::SetSpriteAttributes(void)
 
     // Set attributes for shaders
     // Should be consistent with how we created the buffers for the square
-    GLint vertex_att = glGetAttribLocation(shader_program_, "vertex");
-    glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
-    glEnableVertexAttribArray(vertex_att);
+    if (vertex_att_ >= 0) {
+        glVertexAttribPointer(vertex_att_, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
+        glEnableVertexAttribArray(vertex_att_);
+    }
 
-    GLint color_att = glGetAttribLocation(shader_program_, "color");
-    glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(color_att);
+    if (color_att_ >= 0) {
+        glVertexAttribPointer(color_att_, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(color_att_);
+    }
 
-    GLint tex_att = glGetAttribLocation(shader_program_, "uv");
-    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(tex_att);
+    if (uv_att_ >= 0) {
+        glVertexAttribPointer(uv_att_, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(uv_att_);
+    }
 }
 
 void Shader::SetParticleAttributes(void) {
@@ -248,63 +367,119 @@ void Shader::SetParticleAttributes(void) {
 
     // Set attributes for shaders
     // Should be consistent with how we created the buffers for the particle elements
-    GLint vertex_att = glGetAttribLocation(shader_program_, "vertex");
-    glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
-    glEnableVertexAttribArray(vertex_att);
+    if (vertex_att_ >= 0) {
+        glVertexAttribPointer(vertex_att_, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
+        glEnableVertexAttribArray(vertex_att_);
+    }
 
-    GLint dir_att = glGetAttribLocation(shader_program_, "dir");
-    glVertexAttribPointer(dir_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(dir_att);
+    if (dir_att_ >= 0) {
+        glVertexAttribPointer(dir_att_, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(dir_att_);
+    }
+
+    if (phase_att_ >= 0) {
+        glVertexAttribPointer(phase_att_, 1, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(4 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(phase_att_);
+    }
 
-    GLint time_att = glGetAttribLocation(shader_program_, "t");
-    glVertexAttribPointer(time_att, 1, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(4 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(time_att);
+    if (uv_att_ >= 0) {
+        glVertexAttribPointer(uv_att_, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
+        glEnableVertexAttribArray(uv_att_);
+    }
+}
+
+
+UniformHandle Shader::GetUniform(const GLchar *name) const
+{
+    std::unordered_map<std::string, UniformHandle>::const_iterator it = uniforms_.find(name);
+    if (it == uniforms_.end()) {
+        return -1;
+    }
+    return it->second;
+}
+
+
+void Shader::SetUniform1i(UniformHandle handle, int value)
+{
+
+    glUniform1i(handle, value);
+}
+
+
+void Shader::SetUniform1f(UniformHandle handle, float value)
+{
+
+    glUniform1f(handle, value);
+}
+
+
+void Shader::SetUniform2f(UniformHandle handle, const glm::vec2 &vector)
+{
+
+    glUniform2f(handle, vector.x, vector.y);
+}
+
+
+void Shader::SetUniform3f(UniformHandle handle, const glm::vec3 &vector)
+{
+
+    glUniform3f(handle, vector.x, vector.y, vector.z);
+}
+
+
+void Shader::SetUniform4f(UniformHandle handle, const glm::vec4 &vector)
+{
+
+    glUniform4f(handle, vector.x, vector.y, vector.z, vector.w);
+}
+
+
+void Shader::SetUniformMat4(UniformHandle handle, const glm::mat4 &matrix)
+{
 
-    GLint tex_att = glGetAttribLocation(shader_program_, "uv");
-    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void*)(5 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(tex_att);
+    glUniformMatrix4fv(handle, 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 
 void Shader::SetUniform1i(const GLchar *name, int value)
 {
 
-    glUniform1i(glGetUniformLocation(shader_program_, name), value);
+    glUniform1i(GetUniform(name), value);
 }
 
 
 void Shader::SetUniform1f(const GLchar *name, float value)
 {
 
-    glUniform1f(glGetUniformLocation(shader_program_, name), value);
+    glUniform1f(GetUniform(name), value);
 }
 
 
 void Shader::SetUniform2f(const GLchar *name, const glm::vec2 &vector)
 {
 
-    glUniform2f(glGetUniformLocation(shader_program_, name), vector.x, vector.y);
+    glUniform2f(GetUniform(name), vector.x, vector.y);
 }
 
 
 void Shader::SetUniform3f(const GLchar *name, const glm::vec3 &vector)
 {
 
-    glUniform3f(glGetUniformLocation(shader_program_, name), vector.x, vector.y, vector.z);
+    glUniform3f(GetUniform(name), vector.x, vector.y, vector.z);
 }
 
 
 void Shader::SetUniform4f(const GLchar *name, const glm::vec4 &vector)
 {
 
-    glUniform4f(glGetUniformLocation(shader_program_, name), vector.x, vector.y, vector.z, vector.w);
+    glUniform4f(GetUniform(name), vector.x, vector.y, vector.z, vector.w);
 }
 
 
 void Shader::SetUniformMat4(const GLchar *name, const glm::mat4 &matrix)
 {
 
-    glUniformMatrix4fv(glGetUniformLocation(shader_program_, name), 1, GL_FALSE, glm::value_ptr(matrix));
+    glUniformMatrix4fv(GetUniform(name), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 
@@ -4,18 +4,43 @@
 #define GLEW_STATIC
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "program_cache.h"
 
 #define NUM_PARTICLES 4000
 
 namespace game {
 
+    // Location of a uniform in a program, look it up once with Shader::GetUniform and keep it
+    typedef GLint UniformHandle;
+
     class Shader {
 
         public:
             Shader(void);
             ~Shader();
 
-            void Init(const char *vertPath, const char *fragPath);
+            // Compile and link the program, then record the location of every active uniform and attribute
+            // A program given feedback_varyings writes those vertex shader outputs, interleaved, to the bound transform
+            // feedback buffer, fragPath may then be NULL for a program that never rasterizes
+            void Init(const char *vertPath, const char *fragPath, const std::vector<std::string>& feedback_varyings = std::vector<std::string>());
+
+            // Init() in two halves, so that the driver can build several programs at once (GL_KHR_parallel_shader_compile or its ARB version)
+            // Begin() loads the program from cache when it holds it, or hands the sources to the driver without waiting
+            // Finish() waits for the program, throws std::ios_base::failure if it did not build, stores a freshly linked
+            // program in the cache and records the uniforms and attributes; calling it again does nothing
+            void Begin(const char *vertPath, const char *fragPath, const std::vector<std::string>& feedback_varyings = std::vector<std::string>(), ProgramCache *cache = NULL);
+            void Finish(void);
+
+            // Whether Begin() found the program in the cache
+            inline bool IsFromCache(void) const { return from_cache_; }
+
+            // Connect a uniform block of the program to a buffer binding point (see FrameUniforms)
+            // Does nothing if the program does not use the block
+            void BindUniformBlock(const char *name, GLuint binding);
 
             void Enable();
             void Disable();
@@ -23,8 +48,8 @@ namespace game {
             // Create geometry for sprite
             void CreateSprite(void);
 
-            // Create geometry for particles
-            void CreateParticles(void);
+            // Create geometry for num_particles particles
+            void CreateParticles(int num_particles = NUM_PARTICLES);
 
             // Set shader attributes for sprite
             void SetSpriteAttributes(void);
@@ -32,6 +57,20 @@ namespace game {
             // Set shader attributes for particles
             void SetParticleAttributes(void);
 
+            // Handle of a uniform, -1 if the program has no active uniform with that name
+            UniformHandle GetUniform(const GLchar *name) const;
+
+            // Setters taking a handle go straight to the driver, the program must be enabled
+            // Setting a uniform through a handle of -1 does nothing
+            void SetUniform1i(UniformHandle handle, int value);
+            void SetUniform1f(UniformHandle handle, float value);
+            void SetUniform2f(UniformHandle handle, const glm::vec2 &vector);
+            void SetUniform3f(UniformHandle handle, const glm::vec3 &vector);
+            void SetUniform4f(UniformHandle handle, const glm::vec4 &vector);
+            void SetUniformMat4(UniformHandle handle, const glm::mat4 &matrix);
+
+            // Setters taking a name look the handle up in the table built by Init()
+
             // Sets a uniform integer variable in your shader program to a value
             void SetUniform1i(const GLchar *name, int value);
 
@@ -58,6 +97,26 @@ namespace game {
         private:
             GLuint shader_program_;
 
+            // Shaders being compiled between Begin() and Finish(), 0 once done or when loaded from the cache
+            GLuint vertex_shader_;
+            GLuint fragment_shader_;
+            bool pending_;
+            bool from_cache_;
+
+            // Where to store the program once linked, and under which key
+            ProgramCache *cache_;
+            unsigned long long cache_key_;
+
+            // Active uniforms of the program, filled once by Init()
+            std::unordered_map<std::string, UniformHandle> uniforms_;
+
+            // Attribute locations, -1 for the ones the program does not use
+            GLint vertex_att_;
+            GLint color_att_;
+            GLint uv_att_;
+            GLint dir_att_;
+            GLint phase_att_;
+
             // Geometry of sprite
             GLuint vbo_sprite_;
             GLuint ebo_sprite_;
@@ -1,7 +1,6 @@
 #include <string>
 #include <iostream>
 #include "shield_game_object.h"
-#include <GLFW/glfw3.h>
 
 namespace game {
 
@@ -10,15 +9,16 @@ namespace game {
 		It overrides GameObject's update method, so that you can check for input to change the velocity of the player
 	*/
 
-	ShieldGameObject::ShieldGameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable)
-		: GameObject(position, texture, num_elements, collidable) {}
+	ShieldGameObject::ShieldGameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable)
+		: GameObject(store, position, sprite, num_elements, collidable) {
+		type_ = OBJECT_SHIELD;
+		orbit_offset_ = glm::vec3(0.0f);
+	}
 
 	// Update function for moving the player object around
-	void ShieldGameObject::Update(double delta_time) {
-		double lastTime = glfwGetTime();
-		position_ += velocity_ * ((float)delta_time);
-		// Call the parent's update method to move the object in standard way, if desired
-		//GameObject::Update(delta_time);
+	void ShieldGameObject::Update(double delta_time, double current_time) {
+		// Nothing to steer, the world places the shield on its orbit
+		//GameObject::Update(delta_time, current_time);
 
 	}
 
@@ -9,10 +9,17 @@ namespace game {
     class ShieldGameObject : public GameObject {
 
     public:
-        ShieldGameObject(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable);
+        ShieldGameObject(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable);
 
         // Update function for moving the player object around
-        void Update(double delta_time) override;
+        void Update(double delta_time, double current_time) override;
+
+        // Where the shield sits on its orbit, relative to the player and turning with it; the world sets it every step
+        inline const glm::vec3& GetOrbitOffset(void) const { return orbit_offset_; }
+        inline void SetOrbitOffset(const glm::vec3& offset) { orbit_offset_ = offset; }
+
+    private:
+        glm::vec3 orbit_offset_;
 
     }; // class ShieldGameObject
 
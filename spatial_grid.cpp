@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cmath>
+
+#include "spatial_grid.h"
+
+namespace game {
+
+SpatialGrid::SpatialGrid(float cell_size)
+{
+    cell_size_ = cell_size;
+    num_entries_ = 0;
+}
+
+
+void SpatialGrid::Clear(void)
+{
+    cells_.clear();
+    num_entries_ = 0;
+}
+
+
+int SpatialGrid::CellCoord(float value) const
+{
+    return (int) std::floor(value / cell_size_);
+}
+
+
+long long SpatialGrid::CellKey(int x, int y)
+{
+    // Upper 32 bits for x, lower 32 bits for y
+    // Shifted unsigned, shifting a negative x is undefined; the bits, and so the order of the keys, are the same
+    return (long long) (((unsigned long long) (unsigned int) x << 32) | (unsigned int) y);
+}
+
+
+void SpatialGrid::Insert(int id, const glm::vec3& position, float radius)
+{
+    int x0 = CellCoord(position.x - radius);
+    int x1 = CellCoord(position.x + radius);
+    int y0 = CellCoord(position.y - radius);
+    int y1 = CellCoord(position.y + radius);
+
+    // Register the entry in every cell its bounding square touches
+    for (int x = x0; x <= x1; x++) {
+        for (int y = y0; y <= y1; y++) {
+            Cell cell;
+            cell.key = CellKey(x, y);
+            cell.id = id;
+            cells_.push_back(cell);
+        }
+    }
+    num_entries_++;
+}
+
+
+void SpatialGrid::Build(void)
+{
+    std::sort(cells_.begin(), cells_.end(), [](const Cell& a, const Cell& b) {
+        return a.key < b.key || (a.key == b.key && a.id < b.id);
+    });
+}
+
+
+void SpatialGrid::Query(const glm::vec3& position, float radius, std::vector<int>& result) const
+{
+    result.clear();
+
+    int x0 = CellCoord(position.x - radius);
+    int x1 = CellCoord(position.x + radius);
+    int y0 = CellCoord(position.y - radius);
+    int y1 = CellCoord(position.y + radius);
+
+    for (int x = x0; x <= x1; x++) {
+        for (int y = y0; y <= y1; y++) {
+            long long key = CellKey(x, y);
+
+            // Cells are sorted by key, so the entries of one cell are contiguous
+            std::vector<Cell>::const_iterator it = std::lower_bound(cells_.begin(), cells_.end(), key,
+                [](const Cell& cell, long long k) { return cell.key < k; });
+            for (; it != cells_.end() && it->key == key; ++it) {
+                result.push_back(it->id);
+            }
+        }
+    }
+
+    // Objects spanning several cells are reported once
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+
+void SpatialGrid::CollectPairs(std::vector<std::pair<int, int>>& result) const
+{
+    result.clear();
+
+    size_t start = 0;
+    while (start < cells_.size()) {
+        // Find the run of entries sharing this cell
+        size_t end = start + 1;
+        while (end < cells_.size() && cells_[end].key == cells_[start].key) {
+            end++;
+        }
+
+        // Ids inside a run are sorted, so every pair comes out as (smaller, larger)
+        for (size_t a = start; a < end; a++) {
+            for (size_t b = a + 1; b < end; b++) {
+                result.push_back(std::make_pair(cells_[a].id, cells_[b].id));
+            }
+        }
+        start = end;
+    }
+
+    // Objects sharing several cells would otherwise be reported more than once
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+}
+
+} // namespace game
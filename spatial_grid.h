@@ -0,0 +1,61 @@
+#ifndef SPATIAL_GRID_H_
+#define SPATIAL_GRID_H_
+
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+    /*
+        SpatialGrid is a uniform-grid broad phase
+        Entries are rebuilt every tick: call Clear(), Insert() every object and then Build()
+        Queries only return entries that share a cell with the query area, the exact distance test is left to the caller
+    */
+    class SpatialGrid {
+
+        public:
+            // Cell size should be at least as large as the largest interaction distance
+            SpatialGrid(float cell_size);
+
+            // Remove all entries (keeps the allocated memory for the next tick)
+            void Clear(void);
+
+            // Add an entry covering a circle of the given radius around position
+            void Insert(int id, const glm::vec3& position, float radius);
+
+            // Sort the entries by cell, must be called after the last Insert() and before any query
+            void Build(void);
+
+            // Collect the ids of all entries whose cells overlap the given circle (each id once, in ascending order)
+            void Query(const glm::vec3& position, float radius, std::vector<int>& result) const;
+
+            // Collect every pair of entries sharing at least one cell (each pair once, first < second, sorted)
+            void CollectPairs(std::vector<std::pair<int, int>>& result) const;
+
+            // Getters
+            inline float GetCellSize(void) const { return cell_size_; }
+            inline int GetNumEntries(void) const { return num_entries_; }
+
+        private:
+            // One entry per object per overlapped cell
+            struct Cell {
+                long long key;
+                int id;
+            };
+
+            float cell_size_;
+            int num_entries_;
+            std::vector<Cell> cells_;
+
+            // Cell coordinates of a world position
+            int CellCoord(float value) const;
+
+            // Pack two cell coordinates into a single sortable key
+            static long long CellKey(int x, int y);
+
+    }; // class SpatialGrid
+
+} // namespace game
+
+#endif // SPATIAL_GRID_H_
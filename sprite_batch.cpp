@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "profiler.h"
+#include "sprite_batch.h"
+
+namespace game {
+
+SpriteBatch::SpriteBatch(void)
+{
+    // Don't do work in the constructor, leave it for the Init() function
+    shader_ = NULL;
+    num_elements_ = 0;
+    vbo_instances_ = 0;
+    capacity_ = 0;
+    transformation_att_ = -1;
+    tint_att_ = -1;
+    params_att_ = -1;
+    num_sprites_ = 0;
+    num_draw_calls_ = 0;
+}
+
+
+SpriteBatch::~SpriteBatch()
+{
+    if (vbo_instances_) {
+        glDeleteBuffers(1, &vbo_instances_);
+    }
+}
+
+
+void SpriteBatch::Init(Shader &shader, GLint num_elements)
+{
+    shader_ = &shader;
+    num_elements_ = num_elements;
+
+    transformation_att_ = glGetAttribLocation(shader.GetShaderID(), "instance_transformation");
+    tint_att_ = glGetAttribLocation(shader.GetShaderID(), "instance_tint");
+    params_att_ = glGetAttribLocation(shader.GetShaderID(), "instance_params");
+
+    // The buffer grows when a frame has more sprites than it can hold
+    capacity_ = 1024;
+    glGenBuffers(1, &vbo_instances_);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_instances_);
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(Instance), NULL, GL_STREAM_DRAW);
+}
+
+
+void SpriteBatch::Add(GLuint texture, float layer, const glm::mat4& transformation, const glm::vec4& tint)
+{
+    Sprite sprite;
+    sprite.texture = texture;
+    sprite.order = sprites_.size();
+    sprite.instance.transformation = transformation;
+    sprite.instance.tint = tint;
+    sprite.instance.params = glm::vec2(layer, 0.0f);
+    sprites_.push_back(sprite);
+}
+
+
+void SpriteBatch::SetInstanceAttributes(int first_instance)
+{
+    GLsizei stride = sizeof(Instance);
+    size_t base = first_instance * sizeof(Instance);
+
+    // A mat4 attribute takes four consecutive locations, one per column
+    if (transformation_att_ >= 0) {
+        for (int column = 0; column < 4; column++) {
+            glVertexAttribPointer(transformation_att_ + column, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + column * sizeof(glm::vec4)));
+        }
+    }
+    if (tint_att_ >= 0) {
+        glVertexAttribPointer(tint_att_, 4, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(Instance, tint)));
+    }
+    if (params_att_ >= 0) {
+        glVertexAttribPointer(params_att_, 2, GL_FLOAT, GL_FALSE, stride, (void*)(base + offsetof(Instance, params)));
+    }
+}
+
+
+void SpriteBatch::Flush(void)
+{
+    YUME_PROFILE_ZONE("SpriteBatch::Flush");
+    num_sprites_ = sprites_.size();
+    num_draw_calls_ = 0;
+    if (sprites_.empty()) {
+        return;
+    }
+
+    // Spread the sprites in depth by submission order, so the first ones added stay in front
+    // There is no projection: the view matrix (zoom times lookAt down -z) gives clip z = zoom * (z - camera z),
+    // and clipping keeps [-1, 1], so a sprite in the camera's plane may be pushed back by less than 1 / zoom = 4
+    float depth_step = std::min(0.001f, 4.0f / sprites_.size());
+    for (int i = 0; i < sprites_.size(); i++) {
+        sprites_[i].instance.params.y = sprites_[i].order * depth_step;
+    }
+
+    // Group the sprites by texture
+    std::sort(sprites_.begin(), sprites_.end(), [](const Sprite& a, const Sprite& b) {
+        return a.texture < b.texture || (a.texture == b.texture && a.order < b.order);
+    });
+    instances_.resize(sprites_.size());
+    for (int i = 0; i < sprites_.size(); i++) {
+        instances_[i] = sprites_[i].instance;
+    }
+
+    // Upload all instances at once, orphaning last frame's storage
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_instances_);
+    while (capacity_ < instances_.size()) {
+        capacity_ *= 2;
+    }
+    glBufferData(GL_ARRAY_BUFFER, capacity_ * sizeof(Instance), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances_.size() * sizeof(Instance), &instances_[0]);
+
+    // Other programs may have been used since the last flush
+    shader_->Enable();
+
+    // Per-vertex attributes come from the sprite geometry
+    shader_->SetSpriteAttributes();
+
+    // Per-instance attributes come from the instance buffer
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_instances_);
+    if (transformation_att_ >= 0) {
+        for (int column = 0; column < 4; column++) {
+            glEnableVertexAttribArray(transformation_att_ + column);
+            glVertexAttribDivisor(transformation_att_ + column, 1);
+        }
+    }
+    if (tint_att_ >= 0) {
+        glEnableVertexAttribArray(tint_att_);
+        glVertexAttribDivisor(tint_att_, 1);
+    }
+    if (params_att_ >= 0) {
+        glEnableVertexAttribArray(params_att_);
+        glVertexAttribDivisor(params_att_, 1);
+    }
+
+    // One instanced draw per texture
+    int start = 0;
+    while (start < sprites_.size()) {
+        int end = start + 1;
+        while (end < sprites_.size() && sprites_[end].texture == sprites_[start].texture) {
+            end++;
+        }
+
+        glBindTexture(GL_TEXTURE_2D_ARRAY, sprites_[start].texture);
+        SetInstanceAttributes(start);
+        glDrawElementsInstanced(GL_TRIANGLES, num_elements_, GL_UNSIGNED_INT, 0, end - start);
+        num_draw_calls_++;
+
+        start = end;
+    }
+
+    // Leave the attribute state clean for other programs
+    if (transformation_att_ >= 0) {
+        for (int column = 0; column < 4; column++) {
+            glVertexAttribDivisor(transformation_att_ + column, 0);
+            glDisableVertexAttribArray(transformation_att_ + column);
+        }
+    }
+    if (tint_att_ >= 0) {
+        glVertexAttribDivisor(tint_att_, 0);
+        glDisableVertexAttribArray(tint_att_);
+    }
+    if (params_att_ >= 0) {
+        glVertexAttribDivisor(params_att_, 0);
+        glDisableVertexAttribArray(params_att_);
+    }
+
+    sprites_.clear();
+}
+
+} // namespace game
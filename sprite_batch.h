@@ -0,0 +1,81 @@
+#ifndef SPRITE_BATCH_H_
+#define SPRITE_BATCH_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "shader.h"
+#include "sprite_transform.h"
+
+namespace game {
+
+    /*
+        SpriteBatch collects the sprites of a frame and draws them with instanced rendering
+        Each sprite only costs one entry in an instance buffer (transformation, texture layer and tint),
+        sprites sharing an array texture are drawn together with a single glDrawElementsInstanced call,
+        so a frame drawn from the sprite atlas takes one call
+        Sprites added first end up in front, as when drawing them one by one with the depth test on
+    */
+    class SpriteBatch {
+
+        public:
+            SpriteBatch(void);
+            ~SpriteBatch();
+
+            // Create the instance buffer. shader must be the instanced sprite program, num_elements is the sprite index count
+            void Init(Shader &shader, GLint num_elements);
+
+            // Queue a sprite for drawing, texture is a GL_TEXTURE_2D_ARRAY and layer the sprite's layer in it
+            void Add(GLuint texture, float layer, const glm::mat4& transformation, const glm::vec4& tint = glm::vec4(1.0f));
+
+            // Draw every queued sprite and empty the batch
+            void Flush(void);
+
+            // Statistics of the last flush
+            inline int GetNumSprites(void) const { return num_sprites_; }
+            inline int GetNumDrawCalls(void) const { return num_draw_calls_; }
+
+        private:
+            // Per-instance data, must match the attributes of instanced_vertex_shader.glsl
+            struct Instance {
+                glm::mat4 transformation;
+                glm::vec4 tint;
+                glm::vec2 params; // texture layer, depth
+            };
+
+            // A queued sprite
+            struct Sprite {
+                GLuint texture;
+                int order;
+                Instance instance;
+            };
+
+            Shader *shader_;
+            GLint num_elements_;
+
+            // Instance buffer on the GPU and its capacity in instances
+            GLuint vbo_instances_;
+            int capacity_;
+
+            // Attribute locations in the instanced program
+            GLint transformation_att_;
+            GLint tint_att_;
+            GLint params_att_;
+
+            // Sprites of the current frame and their sorted instance data
+            std::vector<Sprite> sprites_;
+            std::vector<Instance> instances_;
+
+            int num_sprites_;
+            int num_draw_calls_;
+
+            // Point the per-instance attributes at the given instance in the buffer
+            void SetInstanceAttributes(int first_instance);
+
+    }; // class SpriteBatch
+
+} // namespace game
+
+#endif // SPRITE_BATCH_H_
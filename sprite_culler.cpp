@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <cmath>
+
+#include "sprite_culler.h"
+
+namespace game {
+
+SpriteCuller::SpriteCuller(float cell_size)
+    : grid_(cell_size)
+{
+}
+
+
+void SpriteCuller::Build(const std::vector<GameObject*>& objects)
+{
+    grid_.Clear();
+    for (int i = 0; i < objects.size(); i++) {
+        GameObject* object = objects[i];
+
+        // The sprite is drawn anywhere between its last two positions, cover the whole segment
+        glm::vec3 previous = object->GetInterpolatedPosition(0.0f);
+        glm::vec3 current = object->GetInterpolatedPosition(1.0f);
+        float radius = 0.70710678f * object->GetScale() + 0.5f * glm::length(current - previous);
+        grid_.Insert(i, 0.5f * (previous + current), radius);
+    }
+    grid_.Build();
+}
+
+
+void SpriteCuller::Query(const std::vector<GameObject*>& objects, const glm::vec2& center, const glm::vec2& half_extent, float alpha, std::vector<int>& result) const
+{
+    result.clear();
+
+    // The grid answers for a square, the exact test narrows it down to the rectangle
+    grid_.Query(glm::vec3(center, 0.0f), std::max(half_extent.x, half_extent.y), candidates_);
+    for (int k = 0; k < candidates_.size(); k++) {
+        int i = candidates_[k];
+        if (i < objects.size() && Overlaps(objects[i]->GetInterpolatedPosition(alpha), objects[i]->GetScale(), center, half_extent)) {
+            result.push_back(i);
+        }
+    }
+}
+
+} // namespace game
@@ -0,0 +1,52 @@
+#ifndef SPRITE_CULLER_H_
+#define SPRITE_CULLER_H_
+
+#include <cmath>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "game_object.h"
+#include "spatial_grid.h"
+
+namespace game {
+
+    /*
+        SpriteCuller finds the game objects whose sprite overlaps the camera rectangle
+        Objects are indexed in a uniform grid once per simulation step, covering everywhere they are drawn between
+        the last two steps, so every frame until the next step only looks at the cells under the camera
+        The cost of a frame then depends on what is on screen rather than on how many objects the world holds
+    */
+    class SpriteCuller {
+
+        public:
+            // Cell size should be about the size of the camera rectangle
+            SpriteCuller(float cell_size);
+
+            // Index objects, call again whenever the world stepped or objects were added or removed
+            void Build(const std::vector<GameObject*>& objects);
+
+            // Collect the indices of the objects whose sprite, at its position interpolated by alpha,
+            // overlaps the rectangle center +- half_extent (each index once, in ascending order)
+            void Query(const std::vector<GameObject*>& objects, const glm::vec2& center, const glm::vec2& half_extent, float alpha, std::vector<int>& result) const;
+
+            // Number of objects indexed by the last Build()
+            inline int GetNumObjects(void) const { return grid_.GetNumEntries(); }
+
+            // Whether a sprite of the given scale at position overlaps the rectangle
+            static inline bool Overlaps(const glm::vec3& position, float scale, const glm::vec2& center, const glm::vec2& half_extent) {
+                // Half the diagonal of the unit square, any rotation of the sprite stays within it
+                float reach = 0.70710678f * scale;
+                return std::abs(position.x - center.x) <= half_extent.x + reach && std::abs(position.y - center.y) <= half_extent.y + reach;
+            }
+
+        private:
+            SpatialGrid grid_;
+
+            // Candidates of the last query, kept to avoid allocating every frame
+            mutable std::vector<int> candidates_;
+
+    }; // class SpriteCuller
+
+} // namespace game
+
+#endif // SPRITE_CULLER_H_
@@ -0,0 +1,25 @@
+#include <cmath>
+
+#include "sprite_transform.h"
+
+namespace game {
+
+glm::mat4 BuildSpriteTransform(const glm::vec3& position, float angle, float scale)
+{
+    // Same result as translate * rotate * scale, without building the three matrices
+    float radians = glm::radians(angle);
+    float c = std::cos(radians) * scale;
+    float s = std::sin(radians) * scale;
+
+    glm::mat4 transformation(1.0f);
+    transformation[0][0] = c;
+    transformation[0][1] = s;
+    transformation[1][0] = -s;
+    transformation[1][1] = c;
+    transformation[3][0] = position.x;
+    transformation[3][1] = position.y;
+    transformation[3][2] = position.z;
+    return transformation;
+}
+
+} // namespace game
@@ -0,0 +1,13 @@
+#ifndef SPRITE_TRANSFORM_H_
+#define SPRITE_TRANSFORM_H_
+
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Transformation of a sprite: translation * rotation (degrees, around z) * uniform scaling
+    glm::mat4 BuildSpriteTransform(const glm::vec3& position, float angle, float scale);
+
+} // namespace game
+
+#endif // SPRITE_TRANSFORM_H_
@@ -1,7 +1,6 @@
 #include <string>
 #include <iostream>
 #include "star_power_up.h"
-#include <GLFW/glfw3.h>
 
 namespace game {
 
@@ -10,13 +9,15 @@ namespace game {
 		It overrides GameObject's update method, so that you can check for input to change the velocity of the player
 	*/
 
-	StarPowerUp::StarPowerUp(const glm::vec3& position, GLuint texture, GLint num_elements, bool collidable)
-		: GameObject(position, texture, num_elements, collidable) {}
+	StarPowerUp::StarPowerUp(EntityStore& store, const glm::vec3& position, const AtlasRegion& sprite, int num_elements, bool collidable)
+		: GameObject(store, position, sprite, num_elements, collidable) {
+		type_ = OBJECT_STAR_POWER_UP;
+	}
 
 	// Update function for moving the player object around
-	void StarPowerUp::Update(double delta_time) {
+	void StarPowerUp::Update(double delta_time, double current_time) {
 		// Call the parent's update method to move the object in standard way, if desired
-		GameObject::Update(delta_time);
+		GameObject::Update(delta_time, current_time);
 
 	}
 
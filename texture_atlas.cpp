@@ -0,0 +1,194 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "texture_atlas.h"
+
+namespace game {
+
+// Placeholder shown in every layer until its sprite lands: a grey checkerboard
+// Opaque, since the sprite shaders discard every texel with an alpha below 1
+static void FillPlaceholder(unsigned char *pixels, int size)
+{
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            unsigned char value = (((x / 16) + (y / 16)) % 2) ? 160 : 96;
+            unsigned char *pixel = &pixels[(y * size + x) * 4];
+            pixel[0] = value;
+            pixel[1] = value;
+            pixel[2] = value;
+            pixel[3] = 255;
+        }
+    }
+}
+
+
+TextureAtlas::TextureAtlas(void)
+    : cancel_(false)
+{
+    texture_ = 0;
+    pixel_buffer_ = 0;
+    layer_size_ = 0;
+    num_uploaded_ = 0;
+}
+
+
+TextureAtlas::~TextureAtlas()
+{
+    StopLoader();
+    if (pixel_buffer_) {
+        glDeleteBuffers(1, &pixel_buffer_);
+    }
+    if (texture_) {
+        glDeleteTextures(1, &texture_);
+    }
+}
+
+
+void TextureAtlas::Load(const char *filename)
+{
+    StopLoader();
+
+    // Open file
+    std::ifstream f(filename, std::ios::binary);
+    if (f.fail()) {
+        throw(std::ios_base::failure(std::string("Error opening file ") + std::string(filename) + std::string(", build the sprite_atlas target first")));
+    }
+
+    // Check the header
+    AtlasFileHeader header;
+    f.read((char *) &header, sizeof(header));
+    if (!f || strncmp(header.magic, ATLAS_MAGIC, 4) != 0 || header.version != ATLAS_VERSION) {
+        throw(std::ios_base::failure(std::string("Not a sprite atlas: ") + std::string(filename)));
+    }
+    layer_size_ = header.layer_size;
+
+    // Layer names
+    names_.clear();
+    for (unsigned int i = 0; i < header.num_layers; i++) {
+        char name[ATLAS_NAME_LENGTH];
+        f.read(name, ATLAS_NAME_LENGTH);
+        name[ATLAS_NAME_LENGTH - 1] = '\0';
+        names_.push_back(std::string(name));
+    }
+    if (!f) {
+        throw(std::ios_base::failure(std::string("Truncated sprite atlas: ") + std::string(filename)));
+    }
+
+    // Every layer starts out as the placeholder
+    size_t layer_bytes = (size_t) layer_size_ * layer_size_ * 4;
+    std::vector<unsigned char> placeholder(layer_bytes);
+    FillPlaceholder(&placeholder[0], layer_size_);
+
+    if (!texture_) {
+        glGenTextures(1, &texture_);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture_);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layer_size_, layer_size_, header.num_layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    for (unsigned int i = 0; i < header.num_layers; i++) {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, layer_size_, layer_size_, 1, GL_RGBA, GL_UNSIGNED_BYTE, &placeholder[0]);
+    }
+
+    // Texture Wrapping
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Texture Filtering
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // Read the pixels in the background
+    num_uploaded_ = 0;
+    error_.clear();
+    cancel_ = false;
+    loader_ = std::thread(&TextureAtlas::ReadLayers, this, std::string(filename), (std::streamoff) f.tellg());
+}
+
+
+void TextureAtlas::ReadLayers(std::string filename, std::streamoff offset)
+{
+    std::ifstream f(filename.c_str(), std::ios::binary);
+    f.seekg(offset);
+
+    size_t layer_bytes = (size_t) layer_size_ * layer_size_ * 4;
+    for (int i = 0; i < names_.size() && !cancel_; i++) {
+        LoadedLayer layer;
+        layer.layer = i;
+        layer.pixels.resize(layer_bytes);
+        f.read((char *) &layer.pixels[0], layer_bytes);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!f) {
+            error_ = std::string("Truncated sprite atlas: ") + filename;
+            return;
+        }
+        loaded_.push_back(std::move(layer));
+    }
+}
+
+
+void TextureAtlas::Update(int max_layers)
+{
+    if (IsLoaded()) {
+        return;
+    }
+
+    // Take what has arrived, without holding the lock during the upload
+    std::deque<LoadedLayer> layers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error_.empty()) {
+            throw(std::ios_base::failure(error_));
+        }
+        for (int i = 0; i < max_layers && !loaded_.empty(); i++) {
+            layers.push_back(std::move(loaded_.front()));
+            loaded_.pop_front();
+        }
+    }
+    if (layers.empty()) {
+        return;
+    }
+
+    // Stage each layer in the pixel buffer, the copy into the texture then happens on the GPU's schedule
+    size_t layer_bytes = (size_t) layer_size_ * layer_size_ * 4;
+    if (!pixel_buffer_) {
+        glGenBuffers(1, &pixel_buffer_);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer_);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture_);
+    for (int i = 0; i < layers.size(); i++) {
+        // Orphan the previous contents so that the driver does not wait for the last copy
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, layer_bytes, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, layer_bytes, &layers[i].pixels[0]);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layers[i].layer, layer_size_, layer_size_, 1, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        num_uploaded_++;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (IsLoaded()) {
+        StopLoader();
+    }
+}
+
+
+void TextureAtlas::StopLoader(void)
+{
+    cancel_ = true;
+    if (loader_.joinable()) {
+        loader_.join();
+    }
+    loaded_.clear();
+}
+
+
+AtlasRegion TextureAtlas::GetRegion(const std::string& name) const
+{
+    for (int i = 0; i < names_.size(); i++) {
+        if (names_[i] == name) {
+            return AtlasRegion(i);
+        }
+    }
+    throw(std::ios_base::failure(std::string("Sprite not found in atlas: ") + name));
+}
+
+} // namespace game
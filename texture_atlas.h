@@ -0,0 +1,93 @@
+#ifndef TEXTURE_ATLAS_H_
+#define TEXTURE_ATLAS_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "atlas_region.h"
+
+namespace game {
+
+    // Layout of a packed sprite file, written by atlas_packer and read by TextureAtlas:
+    // the header, then num_layers names of ATLAS_NAME_LENGTH bytes, then num_layers RGBA8 images of layer_size x layer_size
+#define ATLAS_MAGIC "YPAK"
+#define ATLAS_VERSION 1
+#define ATLAS_NAME_LENGTH 32
+
+    struct AtlasFileHeader {
+        char magic[4];
+        unsigned int version;
+        unsigned int layer_size;
+        unsigned int num_layers;
+    };
+
+    /*
+        Array texture holding every sprite of the game, one sprite per layer
+        Load() only reads the sprite names and fills every layer with a placeholder, a loader thread reads the pixels
+        in the background and Update(), called on the GL thread every frame, uploads the layers that have arrived
+        The game can start drawing right away, sprites switch from the placeholder to their image as they land
+    */
+    class TextureAtlas {
+
+        public:
+            TextureAtlas(void);
+            ~TextureAtlas();
+
+            // Start loading a packed sprite file into a GL_TEXTURE_2D_ARRAY
+            // Throws std::ios_base::failure if the file cannot be opened or is not a sprite atlas
+            void Load(const char *filename);
+
+            // Upload at most max_layers of the layers read so far through a pixel buffer object
+            // Throws std::ios_base::failure if the loader thread could not read the file
+            void Update(int max_layers = 4);
+
+            // Whether every layer holds its sprite
+            inline bool IsLoaded(void) const { return num_uploaded_ == (int) names_.size(); }
+
+            // Region of the sprite with the given name
+            AtlasRegion GetRegion(const std::string& name) const;
+
+            // Getters
+            inline GLuint GetTexture(void) const { return texture_; }
+            inline int GetLayerSize(void) const { return layer_size_; }
+            inline int GetNumLayers(void) const { return names_.size(); }
+
+        private:
+            GLuint texture_;
+            int layer_size_;
+
+            // Sprite name of each layer
+            std::vector<std::string> names_;
+
+            // Pixel buffer the layers are staged in on their way to the texture
+            GLuint pixel_buffer_;
+
+            // Layers read by the loader thread and not uploaded yet, with their index
+            struct LoadedLayer {
+                int layer;
+                std::vector<unsigned char> pixels;
+            };
+            std::thread loader_;
+            std::mutex mutex_;
+            std::deque<LoadedLayer> loaded_;
+            std::string error_;
+            std::atomic<bool> cancel_;
+            int num_uploaded_;
+
+            // Body of the loader thread: read the layers that follow the names, starting at offset
+            void ReadLayers(std::string filename, std::streamoff offset);
+
+            // Wait for the loader thread
+            void StopLoader(void);
+
+    }; // class TextureAtlas
+
+} // namespace game
+
+#endif // TEXTURE_ATLAS_H_
@@ -0,0 +1,868 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <math.h>
+#include <glm/gtx/vector_angle.hpp>
+
+#include "input_log.h"
+#include "profiler.h"
+#include "world.h"
+#include "player_game_object.h"
+#include "enemy_game_object.h"
+#include "shield_game_object.h"
+#include "buoy_game_object.h"
+#include "shield_power_up.h"
+#include "seeker_game_object.h"
+#include "star_power_up.h"
+#include "penguin_game_object.h"
+#include "arrow_power_up.h"
+
+namespace game {
+
+// Largest distance at which two objects interact (enemies start chasing the player)
+const float interaction_distance_g = 1.5f;
+
+// Size of a broad phase cell, must not be smaller than the interaction distance
+const float broad_phase_cell_size_g = 2.0f;
+
+// Largest number of projectiles in flight, shots fired while the pool is full are dropped
+const int projectile_capacity_g = 4096;
+
+// Objects and projectiles handed to a worker thread at a time
+const int object_grain_g = 256;
+const int projectile_grain_g = 64;
+
+// Steps between two updates of the activity region, and how much farther than the activity radius an object
+// must be to fall asleep, so that objects near the edge do not toggle and nothing reaches the player unawake
+// in between: the player covers less than 2 units in that time, a patrol stays within 2 units of its center
+const int activity_interval_g = 30;
+const float activity_margin_g = 4.0f;
+
+// Projectile properties: speed, seconds in flight and radius added to the target's when testing for a hit
+const float projectile_speed_g = 8.0f;
+const float bullet_lifetime_g = 1.0f;
+const float bullet_radius_g = 0.0f;
+const float arrow_lifetime_g = 3.0f;
+const float arrow_radius_g = 0.5f;
+
+
+// Scene used when no level is given, the same as levels/level1.txt
+static const LevelEntity default_level_g[] = {
+    // type, x, y, scale, mass, flags, state
+    { OBJECT_PLAYER, 0.0f, 0.0f, 1.0f, 10.0f, LEVEL_ENTITY_COLLIDABLE, LEVEL_STATE_NONE },
+
+    // Enemies
+    { OBJECT_ENEMY, -3.0f, 4.0f, 1.0f, 10.0f, LEVEL_ENTITY_COLLIDABLE, LEVEL_STATE_PATROLLING },
+    { OBJECT_ENEMY, 3.0f, -2.0f, 1.0f, 10.0f, LEVEL_ENTITY_COLLIDABLE, LEVEL_STATE_PATROLLING },
+    { OBJECT_ENEMY, 0.8f, 1.5f, 1.0f, 10.0f, LEVEL_ENTITY_COLLIDABLE, LEVEL_STATE_PATROLLING },
+
+    // Power ups
+    { OBJECT_SHIELD_POWER_UP, 3.0f, 1.0f, 1.0f, 0.0f, 0, LEVEL_STATE_NONE },
+    { OBJECT_SHIELD_POWER_UP, -2.0f, -1.0f, 1.0f, 0.0f, 0, LEVEL_STATE_NONE },
+    { OBJECT_STAR_POWER_UP, 3.0f, 3.0f, 1.0f, 0.0f, 0, LEVEL_STATE_NONE },
+    { OBJECT_STAR_POWER_UP, -2.0f, -3.0f, 1.0f, 0.0f, 0, LEVEL_STATE_NONE },
+    { OBJECT_ARROW_POWER_UP, -4.0f, -3.0f, 1.0f, 0.0f, 0, LEVEL_STATE_NONE },
+
+    // Seekers
+    { OBJECT_SEEKER, 3.0f, -2.0f, 1.0f, 5.0f, LEVEL_ENTITY_COLLIDABLE, LEVEL_STATE_MOVING },
+    { OBJECT_SEEKER, -4.0f, 2.0f, 1.0f, 5.0f, LEVEL_ENTITY_COLLIDABLE, LEVEL_STATE_MOVING },
+
+    // Penguins
+    { OBJECT_PENGUIN, 0.0f, 5.0f, 1.0f, 5.0f, 0, LEVEL_STATE_PATROLLING },
+    { OBJECT_PENGUIN, 0.0f, -5.0f, 1.0f, 5.0f, 0, LEVEL_STATE_PATROLLING },
+};
+
+
+World::World(Clock &clock, double timestep, int max_substeps, int num_threads)
+    : clock_(clock), broad_phase_(broad_phase_cell_size_g), projectiles_(projectile_capacity_g), jobs_(num_threads),
+      projectile_scratch_(jobs_.GetNumThreads())
+{
+    timestep_ = timestep;
+    max_substeps_ = max_substeps;
+    last_clock_time_ = 0.0;
+    accumulator_ = 0.0;
+    time_ = 0.0;
+    num_steps_ = 0;
+    num_dropped_steps_ = 0;
+    size_ = 0;
+    num_active_ = 0;
+    activity_radius_ = 0.0f;
+
+    game_over_ = false;
+    invulnerable_ = false;
+    record_log_ = NULL;
+    replay_log_ = NULL;
+    shielded_ = false;
+    invincible_ = false;
+    frozen_ = false;
+    arrow_power_up_ = false;
+    last_bullet_fired_ = -1.0;
+    num_enemies_ = 0;
+    last_invincible_ = 0.0;
+    last_frozen_ = 0.0;
+
+    RegisterInteractions();
+}
+
+
+World::~World()
+{
+    for (int i = 0; i < game_objects_.size(); i++) {
+        delete game_objects_[i];
+    }
+}
+
+
+void World::Setup(const AtlasRegion *sprites, int num_elements, const Level *level)
+{
+    for (int i = 0; i < NUM_SPRITES; i++) {
+        sprites_[i] = sprites[i];
+    }
+    size_ = num_elements;
+
+    const LevelEntity *entities = default_level_g;
+    int num_entities = sizeof(default_level_g) / sizeof(default_level_g[0]);
+    if (level) {
+        entities = level->GetEntities();
+        num_entities = level->GetNumEntities();
+    }
+
+    // One slot per entity and one for the blades, created without growing the storage
+    entities_.Reserve(entities_.GetNumSlots() + num_entities + 1);
+    game_objects_.reserve(game_objects_.size() + num_entities + 1);
+
+    // Setup the player object at the first player entity, or at the origin
+    // Note that, in this specific implementation, the player object should always be the first object in the game object vector
+    glm::vec3 start(0.0f, 0.0f, 0.0f);
+    float mass = 10.0f;
+    for (int i = 0; i < num_entities; i++) {
+        if (entities[i].type == OBJECT_PLAYER) {
+            start = glm::vec3(entities[i].x, entities[i].y, 0.0f);
+            mass = entities[i].mass;
+            break;
+        }
+    }
+    game_objects_.push_back(new PlayerGameObject(entities_, start, sprites_[SPRITE_CHOPPER], size_, true));
+    game_objects_[0]->SetMass(mass);
+
+    // Blades as children of PlayerGameObject
+    // They are drawn relative to the player and never move on their own
+    GameObject *blades = new PlayerGameObject(entities_, start, sprites_[SPRITE_BLADE], size_, false);
+    blades->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f), true);
+    game_objects_[0]->AddChild(blades);
+
+    // Everything else in the order of the level
+    num_enemies_ = 0;
+    for (int i = 0; i < num_entities; i++) {
+        if (entities[i].type == OBJECT_PLAYER) {
+            continue;
+        }
+        game_objects_.push_back(CreateObject(entities[i]));
+        if (entities[i].type == OBJECT_ENEMY || entities[i].type == OBJECT_SEEKER) {
+            num_enemies_++;
+        }
+    }
+
+    // Start stepping from the current clock reading, with nothing to interpolate yet
+    PartitionActive();
+    entities_.SaveState();
+    last_clock_time_ = clock_.GetTime();
+    accumulator_ = 0.0;
+}
+
+
+GameObject* World::CreateObject(const LevelEntity& entity)
+{
+    glm::vec3 position(entity.x, entity.y, 0.0f);
+    bool collidable = (entity.flags & LEVEL_ENTITY_COLLIDABLE) != 0;
+    std::string state = level_state_names_g[entity.state < NUM_LEVEL_STATES ? entity.state : LEVEL_STATE_NONE];
+
+    GameObject *object;
+    switch (entity.type) {
+        case OBJECT_ENEMY:
+            object = new EnemyGameObject(entities_, position, sprites_[SPRITE_ALIEN], size_, collidable, entity.mass, state);
+            break;
+        case OBJECT_SEEKER:
+            object = new SeekerGameObject(entities_, position, sprites_[SPRITE_CLOWN], size_, collidable, entity.mass, state);
+            break;
+        case OBJECT_PENGUIN:
+            object = new PenguinGameObject(entities_, position, sprites_[SPRITE_PENGUIN], size_, collidable, entity.mass, state);
+            break;
+        case OBJECT_BUOY:
+            object = new BuoyGameObject(entities_, position, sprites_[SPRITE_DONUT], size_, collidable, entity.mass);
+            break;
+        case OBJECT_SHIELD_POWER_UP:
+            object = new ShieldPowerUp(entities_, position, sprites_[SPRITE_SHIELD], size_, collidable);
+            break;
+        case OBJECT_STAR_POWER_UP:
+            object = new StarPowerUp(entities_, position, sprites_[SPRITE_STAR], size_, collidable);
+            break;
+        case OBJECT_ARROW_POWER_UP:
+            object = new ArrowPowerUp(entities_, position, sprites_[SPRITE_BOW], size_, collidable);
+            break;
+        default:
+            throw(std::runtime_error(std::string("Level entity of unsupported type ") + std::to_string(entity.type)));
+    }
+    object->SetScale(entity.scale);
+    object->SetMass(entity.mass);
+    return object;
+}
+
+
+void World::SpawnEnemies(int count, float spread, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> coordinate(-spread, spread);
+
+    for (int i = 0; i < count; i++) {
+        // Keep the spawn area around the player clear
+        glm::vec3 position;
+        do {
+            position = glm::vec3(coordinate(generator), coordinate(generator), 0.0f);
+        } while (glm::length(position) < 3.0f);
+
+        game_objects_.push_back(new EnemyGameObject(entities_, position, sprites_[SPRITE_ALIEN], size_, true, 10.0f, "patrolling"));
+        num_enemies_++;
+    }
+    PartitionActive();
+}
+
+
+void World::UpdateActivity(void)
+{
+    YUME_PROFILE_ZONE("World::UpdateActivity");
+    bool limited = activity_radius_ > 0.0f;
+    if (!limited && num_active_ == game_objects_.size()) {
+        return;
+    }
+
+    glm::vec3 center = game_objects_[0]->GetPosition();
+    float wake_distance = activity_radius_;
+    float sleep_distance = activity_radius_ + activity_margin_g;
+
+    bool changed = false;
+    for (int i = 1; i < game_objects_.size(); i++) {
+        GameObject* obj = game_objects_[i];
+        glm::vec3 offset = obj->GetPosition() - center;
+        float distance_squared = offset.x * offset.x + offset.y * offset.y;
+
+        if (obj->IsDormant()) {
+            if (!limited || distance_squared < wake_distance * wake_distance) {
+                obj->Wake(num_steps_ - 1, timestep_);
+                changed = true;
+            }
+        }
+        // Seekers home in on the player from anywhere, they have to keep running
+        else if (limited && distance_squared > sleep_distance * sleep_distance && obj->GetType() != OBJECT_SEEKER) {
+            obj->Sleep(num_steps_ - 1, time_);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        PartitionActive();
+    }
+}
+
+
+void World::PartitionActive(void)
+{
+    if (game_objects_.empty()) {
+        num_active_ = 0;
+        return;
+    }
+
+    // The player never sleeps and stays first
+    std::vector<GameObject*>::iterator first_dormant = std::stable_partition(game_objects_.begin() + 1, game_objects_.end(),
+        [](GameObject* obj) { return !obj->IsDormant(); });
+    num_active_ = first_dormant - game_objects_.begin();
+}
+
+
+int World::Advance(void)
+{
+    YUME_PROFILE_ZONE("World::Advance");
+    double now = clock_.GetTime();
+    accumulator_ += now - last_clock_time_;
+    last_clock_time_ = now;
+
+    int steps = 0;
+    while (accumulator_ >= timestep_ && steps < max_substeps_) {
+        Step();
+        accumulator_ -= timestep_;
+        steps++;
+    }
+
+    // Too far behind: give up on the whole steps left, the simulation slows down instead of spiralling
+    if (accumulator_ >= timestep_) {
+        double dropped = floor(accumulator_ / timestep_);
+        num_dropped_steps_ += (unsigned long long) dropped;
+        accumulator_ -= dropped * timestep_;
+    }
+    return steps;
+}
+
+
+void World::Controls(void) {
+    YUME_PROFILE_ZONE("World::Controls");
+
+    // Get player game object
+    GameObject *player = game_objects_[0];
+    GameObject *blades = player->GetChildren()[0];
+    glm::vec3 curvel = player->GetVelocity();
+
+    float deg_angle = player->GetAngle() + 90;
+    float angle = glm::radians(deg_angle);
+
+    // Check for player input and make changes accordingly
+    if (input_.forward) {
+        player->SetVelocity(curvel + glm::vec3(0.05*glm::cos(angle), 0.05*glm::sin(angle), 0.0f));
+    }
+    if (input_.backward) {
+        player->SetVelocity(curvel - glm::vec3(0.05*glm::cos(angle), 0.05*glm::sin(angle), 0.0f));
+    }
+    if (input_.turn_right) {
+        player->SetAngle(player->GetAngle() - 0.02f);
+        blades->SetAngle(blades->GetAngle() - 0.02f);
+    }
+    if (input_.turn_left) {
+        player->SetAngle(player->GetAngle() + 0.02f);
+        blades->SetAngle(blades->GetAngle() + 0.02f);
+    }
+    if (input_.fire_arrow) {
+        if (arrow_power_up_) {
+            float angle = player->GetAngle() + 90.0;
+            glm::vec3 arrowVelocity = glm::vec3(projectile_speed_g * glm::cos(glm::radians(angle)), projectile_speed_g * glm::sin(glm::radians(angle)), 0.0);
+            projectiles_.Spawn(PROJECTILE_ARROW, player->GetPosition(), arrowVelocity, player->GetAngle(), arrow_lifetime_g, player->GetHandle());
+            arrow_power_up_ = false;
+        }
+    }
+
+    if (input_.fire_bullet) {
+        double bulletDifference = time_ - last_bullet_fired_;
+
+        if (bulletDifference >= 1.0) {
+            // Bullet
+            float angle = player->GetAngle() + 90.0;
+            glm::vec3 bulletVelocity = glm::vec3(projectile_speed_g * glm::cos(glm::radians(angle)), projectile_speed_g * glm::sin(glm::radians(angle)), 0.0);
+            projectiles_.Spawn(PROJECTILE_BULLET, player->GetPosition(), bulletVelocity, player->GetAngle(), bullet_lifetime_g, player->GetHandle());
+            last_bullet_fired_ = time_;
+        }
+    }
+}
+
+
+void World::UpdatePlayerAttachments(double delta_time) {
+    GameObject* player = game_objects_[0];
+
+    // Spin the blades
+    GameObject* blades = player->GetChildren()[0];
+    blades->SetAngle(blades->GetAngle() + 0.3f);
+
+    // Shields orbit around the player
+    // The store integrates attachments along with everything else, given the player's velocity they move along with it
+    float radians = glm::radians(player->GetAngle());
+    float c = std::cos(radians);
+    float s = std::sin(radians);
+    for (int k = 0; k < player->GetShields().size(); k++) {
+        ShieldGameObject* shield = static_cast<ShieldGameObject*>(player->GetShields()[k]);
+        double phase = time_ + k;
+        glm::vec3 offset((float) std::cos(phase), (float) std::sin(phase), 0.0f);
+        shield->SetOrbitOffset(offset);
+        shield->SetPosition(player->GetPosition() + glm::vec3(c * offset.x - s * offset.y, s * offset.x + c * offset.y, 0.0f));
+        shield->SetVelocity(player->GetVelocity(), true);
+        shield->Update(delta_time, time_);
+    }
+}
+
+
+glm::vec3 World::GetVectorBetweenTwoPoints(glm::vec3 start, glm::vec3 destination) {
+
+    return(glm::normalize(glm::vec3(destination.x - start.x, destination.y - start.y, 0)));
+}
+
+void World::createShields(glm::vec3 curpos) {
+    GameObject* player = game_objects_[0];
+    player->AddShield(new ShieldGameObject(entities_, glm::vec3(curpos.x, curpos.y + 1.0f, 0.0f), sprites_[SPRITE_ORB], size_, false));
+    player->AddShield(new ShieldGameObject(entities_, glm::vec3(curpos.x + 1.0f, curpos.y - 0.5f, 0.0f), sprites_[SPRITE_ORB], size_, false));
+    player->AddShield(new ShieldGameObject(entities_, glm::vec3(curpos.x - 1.0f, curpos.y - 0.5f, 0.0f), sprites_[SPRITE_ORB], size_, false));
+    player->AddShield(new ShieldGameObject(entities_, glm::vec3(curpos.x - 1.0f, curpos.y - 0.5f, 0.0f), sprites_[SPRITE_ORB], size_, false));
+    player->AddShield(new ShieldGameObject(entities_, glm::vec3(curpos.x - 1.0f, curpos.y - 0.5f, 0.0f), sprites_[SPRITE_ORB], size_, false));
+    player->AddShield(new ShieldGameObject(entities_, glm::vec3(curpos.x - 1.0f, curpos.y - 0.5f, 0.0f), sprites_[SPRITE_ORB], size_, false));
+}
+
+void World::FindProjectileHits(int i, double delta_time, ProjectileScratch& scratch) const {
+    ProjectileKind kind = projectiles_.GetKind(i);
+    glm::vec3 start = projectiles_.GetPosition(i);
+    glm::vec3 motion = projectiles_.GetVelocity(i) * (float) delta_time;
+    float projectile_radius = (kind == PROJECTILE_ARROW) ? arrow_radius_g : bullet_radius_g;
+
+    // Every object is in the cells under its own circle, so a circle around the segment covered
+    // during the step, grown by the projectile radius, reaches the cells of anything it can hit
+    float reach = 0.5f * glm::length(motion) + projectile_radius;
+    broad_phase_.Query(start + 0.5f * motion, reach, scratch.candidates);
+
+    // Pack the circles of the enemies among them for the kernel
+    scratch.targets.Clear();
+    scratch.target_ids.clear();
+    for (int k = 0; k < scratch.candidates.size(); k++) {
+        int j = scratch.candidates[k];
+        GameObject* target = game_objects_[j];
+        if (target->IsPendingDestroy() || (target->GetType() != OBJECT_ENEMY && target->GetType() != OBJECT_SEEKER)) {
+            continue;
+        }
+        scratch.targets.Add(glm::vec2(target->GetPosition()), 0.5f * target->GetScale() + projectile_radius);
+        scratch.target_ids.push_back(j);
+    }
+    if (scratch.target_ids.empty()) {
+        return;
+    }
+
+    // Sweep over this step's motion, t in [0, 1]
+    float t;
+    if (kind == PROJECTILE_ARROW) {
+        // The arrow goes through, so it hits every enemy it touches
+        scratch.hit_times.resize(scratch.target_ids.size());
+        RayCirclesEarliestHit(glm::vec2(start), glm::vec2(motion), scratch.targets, 1.0f, t, &scratch.hit_times[0]);
+        for (int k = 0; k < scratch.target_ids.size(); k++) {
+            if (scratch.hit_times[k] >= 0.0f) {
+                scratch.hits.push_back(std::make_pair(i, scratch.target_ids[k]));
+            }
+        }
+    }
+    else {
+        int hit = RayCirclesEarliestHit(glm::vec2(start), glm::vec2(motion), scratch.targets, 1.0f, t);
+        if (hit >= 0) {
+            scratch.hits.push_back(std::make_pair(i, scratch.target_ids[hit]));
+        }
+    }
+}
+
+void World::UpdateProjectiles(double delta_time) {
+    YUME_PROFILE_ZONE("World::UpdateProjectiles");
+    // The broad phase holds this step's positions of every object that can be hit
+    int count = projectiles_.GetCount();
+    for (int w = 0; w < projectile_scratch_.size(); w++) {
+        projectile_scratch_[w].hits.clear();
+    }
+    jobs_.ParallelFor(0, count, projectile_grain_g, [&](int begin, int end, int worker) {
+        for (int i = begin; i < end; i++) {
+            FindProjectileHits(i, delta_time, projectile_scratch_[worker]);
+        }
+    });
+
+    // Apply the hits in projectile order, so the outcome does not depend on which thread found them
+    projectile_hits_.clear();
+    for (int w = 0; w < projectile_scratch_.size(); w++) {
+        projectile_hits_.insert(projectile_hits_.end(), projectile_scratch_[w].hits.begin(), projectile_scratch_[w].hits.end());
+    }
+    std::sort(projectile_hits_.begin(), projectile_hits_.end());
+
+    projectile_spent_.assign(count, 0);
+    ProjectileScratch& retry = projectile_scratch_[0];
+    for (int k = 0; k < projectile_hits_.size(); k++) {
+        int i = projectile_hits_[k].first;
+        int j = projectile_hits_[k].second;
+
+        if (projectiles_.GetKind(i) == PROJECTILE_ARROW) {
+            KillEnemy(j);
+            continue;
+        }
+
+        // An earlier bullet took this enemy: look again for what else is in the way
+        if (game_objects_[j]->IsPendingDestroy()) {
+            retry.hits.clear();
+            FindProjectileHits(i, delta_time, retry);
+            if (retry.hits.empty()) {
+                continue;
+            }
+            j = retry.hits[0].second;
+        }
+
+        // A bullet stops at the first enemy on its way, and the gun is ready again
+        KillEnemy(j);
+        last_bullet_fired_ = -1.5;
+        projectile_spent_[i] = 1;
+    }
+
+    // Move on, or disappear at the end of the flight
+    // Going backwards, the projectile swapped into a removed one's place has already been handled
+    for (int i = count - 1; i >= 0; i--) {
+        projectiles_.GetPosition(i) += projectiles_.GetVelocity(i) * (float) delta_time;
+        projectiles_.GetLifetime(i) -= delta_time;
+        if (projectile_spent_[i] || projectiles_.GetLifetime(i) <= 0.0f) {
+            projectiles_.Remove(i);
+        }
+    }
+}
+
+void World::buoyCollision(GameObject* object, GameObject* buoy) {
+    glm::vec3 n = glm::normalize(object->GetPosition() - buoy->GetPosition());
+    glm::vec3 v1 = object->GetVelocity();
+    glm::vec3 v2 = buoy->GetVelocity();
+
+    float m1 = object->GetMass();
+    float m2 = buoy->GetMass();
+
+    glm::vec3 v1prime = v1 - ((2 * m2) / (m1 + m2)) * (glm::dot(n, v1 - v2)) * n;
+    glm::vec3 v2prime = v2 - ((2 * m1) / (m1 + m2)) * (glm::dot(n, v2 - v1)) * n;
+
+    object->SetVelocity(v1prime);
+    buoy->SetVelocity(v2prime);
+}
+
+void World::RegisterInteraction(ObjectType first, ObjectType second, InteractionHandler handler) {
+    interactions_[first][second] = handler;
+    interacts_[first] = true;
+    interacts_[second] = true;
+}
+
+void World::RegisterInteractions(void) {
+    for (int a = 0; a < NUM_OBJECT_TYPES; a++) {
+        interacts_[a] = false;
+        for (int b = 0; b < NUM_OBJECT_TYPES; b++) {
+            interactions_[a][b] = NULL;
+        }
+    }
+
+    // The player is always the first object, so it is always the first of its pairs
+    RegisterInteraction(OBJECT_PLAYER, OBJECT_ENEMY, &World::PlayerEnemyInteraction);
+    RegisterInteraction(OBJECT_PLAYER, OBJECT_SEEKER, &World::PlayerSeekerInteraction);
+    RegisterInteraction(OBJECT_PLAYER, OBJECT_PENGUIN, &World::PlayerPenguinInteraction);
+    RegisterInteraction(OBJECT_PLAYER, OBJECT_SHIELD_POWER_UP, &World::ShieldPowerUpInteraction);
+    RegisterInteraction(OBJECT_PLAYER, OBJECT_STAR_POWER_UP, &World::StarPowerUpInteraction);
+    RegisterInteraction(OBJECT_PLAYER, OBJECT_ARROW_POWER_UP, &World::ArrowPowerUpInteraction);
+
+    // Anything solid bounces off a buoy that comes after it
+    RegisterInteraction(OBJECT_PLAYER, OBJECT_BUOY, &World::BuoyInteraction);
+    RegisterInteraction(OBJECT_ENEMY, OBJECT_BUOY, &World::BuoyInteraction);
+    RegisterInteraction(OBJECT_SEEKER, OBJECT_BUOY, &World::BuoyInteraction);
+    RegisterInteraction(OBJECT_BUOY, OBJECT_BUOY, &World::BuoyInteraction);
+}
+
+void World::BuildBroadPhase(void) {
+    broad_phase_.Clear();
+    for (int i = 0; i < num_active_; i++) {
+        GameObject* obj = game_objects_[i];
+
+        // Objects without any registered interaction (backgrounds) stay out of the broad phase
+        if (!interacts_[obj->GetType()]) {
+            continue;
+        }
+
+        // Cover half the interaction distance around each object so that any two objects
+        // closer than the interaction distance share at least one cell
+        float radius = 0.5f * std::max(obj->GetScale(), interaction_distance_g);
+        broad_phase_.Insert(i, obj->GetPosition(), radius);
+    }
+    broad_phase_.Build();
+}
+
+void World::HandleCollision(int i, int j) {
+    GameObject* current_game_object = game_objects_[i];
+    GameObject* other_game_object = game_objects_[j];
+
+    // Pairs that cannot interact are rejected on their tags alone
+    InteractionHandler handler = interactions_[current_game_object->GetType()][other_game_object->GetType()];
+    if (!handler) {
+        return;
+    }
+
+    float distance = glm::length(current_game_object->GetPosition() - other_game_object->GetPosition());
+    if (distance >= interaction_distance_g) {
+        return;
+    }
+
+    (this->*handler)(i, j, distance);
+}
+
+void World::ChasePlayer(int i, int j) {
+    GameObject* current_game_object = game_objects_[i];
+    GameObject* other_game_object = game_objects_[j];
+
+    other_game_object->SetState("moving");
+    glm::vec3 resultantVector = GetVectorBetweenTwoPoints(other_game_object->GetPosition(), current_game_object->GetPosition());
+
+    float angle = glm::angle(resultantVector, glm::normalize(glm::vec3(1.0f, 0.0f, 0.0f)));
+
+    // Enemy state = moving
+    other_game_object->SetVelocity(glm::vec3(resultantVector.x, resultantVector.y, 0.0f));
+    other_game_object->SetAngle(angle + 90);
+}
+
+void World::ContactDamage(int i, int j, float distance) {
+    GameObject* current_game_object = game_objects_[i];
+    GameObject* other_game_object = game_objects_[j];
+
+    if (distance >= 1.0f || !current_game_object->GetCollidable() || !other_game_object->GetCollidable()) {
+        return;
+    }
+
+    if (!shielded_) { // Not shielded
+        if (invulnerable_) {
+            return;
+        }
+
+        std::cout << "Explode" << std::endl;
+        game_over_ = true;
+
+        current_game_object->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
+        other_game_object->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
+
+        // The player and every enemy blow up, the front-end plays the sound
+        current_game_object->SetSprite(sprites_[SPRITE_EXPLOSION]);
+        for (int k = 0; k < game_objects_.size(); k++) {
+            if (game_objects_[k]->GetType() == OBJECT_ENEMY) {
+                game_objects_[k]->SetSprite(sprites_[SPRITE_EXPLOSION]);
+            }
+        }
+
+        WorldEvent event;
+        event.type = WorldEventType::PlayerExploded;
+        event.position = current_game_object->GetPosition();
+        events_.push_back(event);
+    }
+    else { // Shielded
+        KillEnemy(j);
+        current_game_object->RemoveShields();
+        shielded_ = false;
+    }
+}
+
+void World::PlayerEnemyInteraction(int i, int j, float distance) {
+    // Player/Enemy interaction (Moving)
+    ChasePlayer(i, j);
+    ContactDamage(i, j, distance);
+}
+
+void World::PlayerSeekerInteraction(int i, int j, float distance) {
+    // Seekers already home in on the player, only contact matters
+    ContactDamage(i, j, distance);
+}
+
+void World::PlayerPenguinInteraction(int i, int j, float distance) {
+    ChasePlayer(i, j);
+
+    if (distance < 1.0f) {
+        Destroy(j); // Erases the penguin
+        last_frozen_ = time_;
+        frozen_ = true;
+        game_objects_[i]->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
+    }
+}
+
+void World::BuoyInteraction(int i, int j, float distance) {
+    if (distance < 1.0f && game_objects_[i]->GetCollidable() && game_objects_[j]->GetCollidable()) {
+        buoyCollision(game_objects_[i], game_objects_[j]);
+    }
+}
+
+void World::ShieldPowerUpInteraction(int i, int j, float distance) {
+    GameObject* current_game_object = game_objects_[i];
+
+    // Checking for collision of power up
+    if (distance < 1.0f) {
+        glm::vec3 curpos = current_game_object->GetPosition();
+
+        CollectPowerUp(j); // Erases the power up
+
+        if (!shielded_) {
+            createShields(curpos);
+
+            for (int k = 0; k < current_game_object->GetShields().size(); k++) {
+                GameObject* shield = current_game_object->GetShields()[k];
+                shield->SetScale(0.25f);
+            }
+            shielded_ = true;
+        }
+    }
+}
+
+void World::StarPowerUpInteraction(int i, int j, float distance) {
+    if (distance < 1.0f) {
+        CollectPowerUp(j); // Erases the power up
+
+        game_objects_[i]->SetCollidable(false);
+        last_invincible_ = time_;
+        invincible_ = true;
+    }
+}
+
+void World::ArrowPowerUpInteraction(int i, int j, float distance) {
+    if (distance < 1.0f) {
+        CollectPowerUp(j); // Erases the power up
+        arrow_power_up_ = true;
+    }
+}
+
+void World::Destroy(int i) {
+    GameObject* obj = game_objects_[i];
+    if (!obj->IsPendingDestroy()) {
+        obj->SetPendingDestroy();
+        pending_destroy_.push_back(obj->GetHandle());
+    }
+}
+
+void World::KillEnemy(int i) {
+    if (!game_objects_[i]->IsPendingDestroy()) {
+        Destroy(i);
+        num_enemies_--;
+
+        WorldEvent event;
+        event.type = WorldEventType::EnemyKilled;
+        event.position = game_objects_[i]->GetPosition();
+        events_.push_back(event);
+    }
+}
+
+void World::CollectPowerUp(int i) {
+    if (!game_objects_[i]->IsPendingDestroy()) {
+        Destroy(i);
+
+        WorldEvent event;
+        event.type = WorldEventType::PowerUpCollected;
+        event.position = game_objects_[i]->GetPosition();
+        events_.push_back(event);
+    }
+}
+
+void World::FlushDestroyed(void) {
+    YUME_PROFILE_ZONE("World::FlushDestroyed");
+    if (pending_destroy_.empty()) {
+        return;
+    }
+
+    // Keep the survivors in order, the player stays first and the awake objects before the sleeping ones
+    int kept = 0;
+    int kept_active = 0;
+    for (int i = 0; i < game_objects_.size(); i++) {
+        if (!game_objects_[i]->IsPendingDestroy()) {
+            game_objects_[kept++] = game_objects_[i];
+            if (i < num_active_) {
+                kept_active++;
+            }
+        }
+    }
+    game_objects_.resize(kept);
+    num_active_ = kept_active;
+
+    // Deleting frees the entities, so the handles of the dead stop resolving
+    for (int k = 0; k < pending_destroy_.size(); k++) {
+        delete entities_.Resolve(pending_destroy_[k]);
+    }
+    pending_destroy_.clear();
+}
+
+void World::Step(void) {
+    YUME_PROFILE_ZONE("World::Step");
+
+    // Nothing moves once the game is over
+    if (IsOver()) {
+        return;
+    }
+
+    double delta_time = timestep_;
+    time_ += delta_time;
+    num_steps_++;
+
+    // The input of this tick comes from the replay, and goes into the recording
+    unsigned int tick = (unsigned int) (num_steps_ - 1);
+    if (replay_log_) {
+        input_ = replay_log_->Get(tick);
+    }
+    if (record_log_) {
+        record_log_->Record(tick, input_);
+    }
+
+    // Objects wake up before the state is saved, so that the renderer does not sweep them over the distance they jumped
+    if (num_steps_ % activity_interval_g == 0) {
+        UpdateActivity();
+    }
+
+    // Keep the state the renderer interpolates from
+    entities_.SaveState();
+
+    // Handle user input
+    if (!frozen_) {
+        Controls();
+    }
+
+    // Let every awake game object steer, then move all entities in one pass over the store
+    // Behaviours only write their own object, so they run on every thread
+    jobs_.ParallelFor(0, num_active_, object_grain_g, [&](int begin, int end, int worker) {
+        for (int i = begin; i < end; i++) {
+            game_objects_[i]->Update(delta_time, time_);
+        }
+    });
+    UpdatePlayerAttachments(delta_time);
+    jobs_.ParallelFor(0, entities_.GetNumSlots(), 4 * object_grain_g, [&](int begin, int end, int worker) {
+        entities_.Integrate(delta_time, begin, end);
+    });
+
+    // Interactions that do not depend on distance
+    GameObject* player = game_objects_[0];
+    jobs_.ParallelFor(1, num_active_, object_grain_g, [&](int begin, int end, int worker) {
+        for (int i = begin; i < end; i++) {
+            GameObject* other_game_object = game_objects_[i];
+
+            // Seekers always home in on the player
+            if (other_game_object->GetType() == OBJECT_SEEKER) {
+                glm::vec3 resultantVector = GetVectorBetweenTwoPoints(other_game_object->GetPosition(), player->GetPosition());
+
+                float angle = glm::angle(resultantVector, glm::normalize(glm::vec3(1.0f, 0.0f, 0.0f)));
+
+                other_game_object->SetVelocity(glm::vec3(resultantVector.x, resultantVector.y, 0.0f));
+                other_game_object->SetAngle(angle + 90);
+            }
+            // Enemies go back to patrolling unless the collision pass finds the player close enough
+            else if (other_game_object->GetType() == OBJECT_ENEMY || other_game_object->GetType() == OBJECT_PENGUIN) {
+                other_game_object->SetState("patrolling");
+            }
+        }
+    });
+
+    {
+        YUME_PROFILE_ZONE("World::Collisions");
+
+        // Broad phase: only objects sharing a grid cell are tested against each other
+        BuildBroadPhase();
+        broad_phase_.CollectPairs(candidate_pairs_);
+
+        // Narrow phase, in the same (i, j > i) order as a full pairwise pass
+        for (int k = 0; k < candidate_pairs_.size(); k++) {
+            int i = candidate_pairs_[k].first;
+            int j = candidate_pairs_[k].second;
+            if (game_objects_[i]->IsPendingDestroy() || game_objects_[j]->IsPendingDestroy()) {
+                continue;
+            }
+            HandleCollision(i, j);
+        }
+    }
+
+    // Timed player effects
+    double invincibleDifference = time_ - last_invincible_;
+    double frozenDifference = time_ - last_frozen_;
+
+    if (invincible_) {
+        if (invincibleDifference >= 5.0) {
+            player->SetCollidable(true);
+            invincible_ = false;
+        }
+    }
+    if (frozen_) {
+        if (frozenDifference >= 3.0) {
+            frozen_ = false;
+        }
+    }
+
+    // Bullets and arrows hit what is in their way this step
+    UpdateProjectiles(delta_time);
+
+    // Everything destroyed during the step goes away together
+    FlushDestroyed();
+}
+
+} // namespace game
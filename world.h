@@ -0,0 +1,271 @@
+#ifndef WORLD_H_
+#define WORLD_H_
+
+#include <glm/glm.hpp>
+#include <utility>
+#include <vector>
+
+#include "atlas_region.h"
+#include "clock.h"
+#include "entity_store.h"
+#include "game_object.h"
+#include "job_system.h"
+#include "level.h"
+#include "projectile_pool.h"
+#include "ray_circle.h"
+#include "spatial_grid.h"
+
+namespace game {
+
+    class InputLog;
+
+    // Player commands for one simulation step
+    struct PlayerInput {
+        bool forward;
+        bool backward;
+        bool turn_left;
+        bool turn_right;
+        bool fire_bullet;
+        bool fire_arrow;
+
+        PlayerInput(void) : forward(false), backward(false), turn_left(false), turn_right(false), fire_bullet(false), fire_arrow(false) {}
+    };
+
+    // Things that happened during a step which the front-end may want to show or play
+    enum class WorldEventType {
+        PlayerExploded,
+        EnemyKilled,
+        PowerUpCollected
+    };
+
+    struct WorldEvent {
+        WorldEventType type;
+        glm::vec3 position;
+    };
+
+    /*
+        World is the simulation core of the game
+        It owns the game objects and steps them with a fixed timestep, driven by an injected clock
+        It does not touch the window, the OpenGL context or the audio device, so it can run headless
+    */
+    class World {
+
+        public:
+            // The clock must outlive the world
+            // Advance() runs at most max_substeps steps per call and drops the time it could not catch up with,
+            // so that a slow frame cannot make the next one slower still
+            // Per-object work is spread over num_threads threads (0 for every hardware thread), with the same
+            // results whatever the number
+            World(Clock &clock, double timestep = 1.0 / 60.0, int max_substeps = 8, int num_threads = 1);
+            ~World();
+
+            // Create the scene. sprites holds the atlas region of every SpriteId (the defaults will do when running headless)
+            // The entities come from level, or from the built-in scene (levels/level1.txt) when it is NULL
+            // Throws std::runtime_error if the level holds an entity of a type that cannot be placed
+            void Setup(const AtlasRegion *sprites, int num_elements, const Level *level = NULL);
+
+            // Add patrolling enemies scattered around the origin, for stress tests
+            void SpawnEnemies(int count, float spread, unsigned int seed);
+
+            // Keep the player alive whatever hits it, for long unattended runs
+            inline void SetPlayerInvulnerable(bool invulnerable) { invulnerable_ = invulnerable; }
+
+            // Put objects farther than radius from the player to sleep, 0 keeps every object awake
+            // Sleeping objects skip behaviours, interactions and hit tests; waking, they jump to where they would have been
+            // The radius should exceed how far projectiles fly, or they pass through sleeping enemies
+            inline void SetActivityRadius(float radius) { activity_radius_ = radius; }
+
+            // Input used by the following steps
+            inline void SetInput(const PlayerInput& input) { input_ = input; }
+
+            // Log the input every step sees into log, or take it from log instead of SetInput(); NULL stops either
+            // The log must outlive its use
+            inline void RecordInput(InputLog* log) { record_log_ = log; }
+            inline void ReplayInput(const InputLog* log) { replay_log_ = log; }
+
+            // Run as many fixed steps as needed to catch up with the clock, returns the number of steps taken
+            int Advance(void);
+
+            // How far the clock is between the last step and the next one, in [0, 1), for render interpolation
+            inline float GetInterpolationAlpha(void) const { return (float) (accumulator_ / timestep_); }
+
+            // Run a single fixed step
+            void Step(void);
+
+            // The game ends when the player dies or every enemy is gone
+            inline bool IsOver(void) const { return game_over_ || num_enemies_ == 0; }
+
+            // Getters
+            inline double GetTime(void) const { return time_; }
+            inline double GetTimestep(void) const { return timestep_; }
+            inline unsigned long long GetNumSteps(void) const { return num_steps_; }
+            inline unsigned long long GetNumDroppedSteps(void) const { return num_dropped_steps_; }
+            inline std::vector<GameObject*>& GetGameObjects(void) { return game_objects_; }
+            inline int GetNumActive(void) const { return num_active_; }
+            inline float GetActivityRadius(void) const { return activity_radius_; }
+            inline EntityStore& GetEntities(void) { return entities_; }
+            inline GameObject* GetPlayer(void) { return game_objects_[0]; }
+            inline const ProjectilePool& GetProjectiles(void) const { return projectiles_; }
+            inline int GetNumThreads(void) const { return jobs_.GetNumThreads(); }
+
+            // Events produced since the last call to ClearEvents()
+            inline const std::vector<WorldEvent>& GetEvents(void) const { return events_; }
+            inline void ClearEvents(void) { events_.clear(); }
+
+        private:
+            // Time source and fixed timestep
+            Clock &clock_;
+            double timestep_;
+            int max_substeps_;
+            double last_clock_time_;
+            double accumulator_;
+
+            // Simulation time and number of steps taken
+            double time_;
+            unsigned long long num_steps_;
+            unsigned long long num_dropped_steps_;
+
+            // Atlas regions and geometry size handed to new objects
+            AtlasRegion sprites_[NUM_SPRITES];
+            int size_;
+
+            // Hot state of every object, attachments included
+            EntityStore entities_;
+
+            // List of game objects, the player is always the first one
+            // The awake objects come first, a step only goes over those num_active_
+            std::vector<GameObject*> game_objects_;
+            int num_active_;
+
+            // Distance from the player beyond which objects sleep, 0 for never
+            float activity_radius_;
+
+            // Broad phase for collision detection, rebuilt every step
+            SpatialGrid broad_phase_;
+
+            // Candidate pairs (indices into game_objects_) found by the broad phase
+            std::vector<std::pair<int, int>> candidate_pairs_;
+
+            // Bullets and arrows in flight
+            ProjectilePool projectiles_;
+
+            // Threads for the per-object work of a step
+            JobSystem jobs_;
+
+            // Scratch lists for projectile hit tests: broad phase candidates, the circles of those that can be hit
+            // with their indices into game_objects_, the entry time into each circle and the hits found,
+            // as (projectile, game object) pairs
+            struct ProjectileScratch {
+                std::vector<int> candidates;
+                CircleSet targets;
+                std::vector<int> target_ids;
+                std::vector<float> hit_times;
+                std::vector<std::pair<int, int>> hits;
+            };
+
+            // One set per worker thread, and the hits of all of them merged
+            std::vector<ProjectileScratch> projectile_scratch_;
+            std::vector<std::pair<int, int>> projectile_hits_;
+            std::vector<unsigned char> projectile_spent_;
+
+            // Objects destroyed during the step, deleted all at once when it ends
+            std::vector<EntityHandle> pending_destroy_;
+
+            // Current input and produced events
+            PlayerInput input_;
+            InputLog* record_log_;
+            const InputLog* replay_log_;
+            std::vector<WorldEvent> events_;
+
+            // Game state
+            bool game_over_;
+            bool invulnerable_;
+            bool shielded_;
+            bool invincible_;
+            bool frozen_;
+            bool arrow_power_up_;
+            double last_bullet_fired_;
+            unsigned int num_enemies_;
+            double last_invincible_;
+            double last_frozen_;
+
+            // Create the object described by a level entity, other than the player
+            GameObject* CreateObject(const LevelEntity& entity);
+
+            // Every few steps, put the objects that left the activity region to sleep and wake those it reached
+            void UpdateActivity(void);
+
+            // Move the awake objects in front of the sleeping ones, keeping their order, and count them
+            void PartitionActive(void);
+
+            // Apply the player input
+            void Controls(void);
+
+            // Move the player's blades and shields
+            void UpdatePlayerAttachments(double delta_time);
+
+            glm::vec3 GetVectorBetweenTwoPoints(glm::vec3 start, glm::vec3 destination);
+
+            void createShields(glm::vec3 curpos);
+
+            // Sweep every projectile over this step's motion against the broad phase, apply the hits and move it
+            // The sweeps run in parallel, the kills are applied afterwards in projectile order
+            void UpdateProjectiles(double delta_time);
+
+            // Add to scratch.hits what projectile i hits this step: the earliest enemy for a bullet, every enemy for an arrow
+            // Only reads the world, so it can run on any thread
+            void FindProjectileHits(int i, double delta_time, ProjectileScratch& scratch) const;
+
+            void buoyCollision(GameObject* object, GameObject* buoy);
+
+            // Response to a pair of objects (i < j) closer than the interaction distance
+            typedef void (World::*InteractionHandler)(int i, int j, float distance);
+
+            // Handler of each (first type, second type) pair, NULL when the types do not interact
+            InteractionHandler interactions_[NUM_OBJECT_TYPES][NUM_OBJECT_TYPES];
+
+            // Whether a type takes part in any interaction
+            bool interacts_[NUM_OBJECT_TYPES];
+
+            // Fill the interaction table
+            void RegisterInteractions(void);
+            void RegisterInteraction(ObjectType first, ObjectType second, InteractionHandler handler);
+
+            // Fill the broad phase with every object that can take part in an interaction
+            void BuildBroadPhase(void);
+
+            // Look the pair (i < j) up in the interaction table and run its handler if the objects are close enough
+            void HandleCollision(int i, int j);
+
+            // Interaction handlers
+            void PlayerEnemyInteraction(int i, int j, float distance);
+            void PlayerSeekerInteraction(int i, int j, float distance);
+            void PlayerPenguinInteraction(int i, int j, float distance);
+            void BuoyInteraction(int i, int j, float distance);
+            void ShieldPowerUpInteraction(int i, int j, float distance);
+            void StarPowerUpInteraction(int i, int j, float distance);
+            void ArrowPowerUpInteraction(int i, int j, float distance);
+
+            // Enemy j turns toward the player i
+            void ChasePlayer(int i, int j);
+
+            // Player i touching enemy j: lose the shield, or explode
+            void ContactDamage(int i, int j, float distance);
+
+            // Queue game object i for destruction, doing it again is harmless
+            void Destroy(int i);
+
+            // Destroy enemy i and count it as defeated
+            void KillEnemy(int i);
+
+            // Destroy power up i, picked up by the player
+            void CollectPowerUp(int i);
+
+            // Delete the queued objects and close the gaps in game_objects_ in a single pass
+            void FlushDestroyed(void);
+
+    }; // class World
+
+} // namespace game
+
+#endif // WORLD_H_